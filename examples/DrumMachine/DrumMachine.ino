@@ -5,7 +5,7 @@
  * This example demonstrates:
  * - Percussive synthesis techniques
  * - Multiple sound generators (kick, snare, hi-hat)
- * - Sequencer with programmable patterns
+ * - Sample-accurate sequencer with programmable patterns
  * - Real-time tempo control
  * 
  * Sounds generated:
@@ -136,11 +136,20 @@ private:
   SnareDrum snare;
   HiHat hihat;
   
-  // Sequencer variables
+  // Sequencer variables (loop() side). Steps are stamped with the
+  // render frame they start on, a little ahead of time, so every hit
+  // lands on its exact sample whatever loop() is doing.
+  static constexpr uint32_t LOOKAHEAD_FRAMES = KoeKit::SAMPLE_RATE / 20;  // 50 ms
   int currentStep = 0;
-  unsigned long lastStepTime = 0;
+  uint32_t nextStepFrame = 0;
+  uint32_t stepRemainder = 0;
   int bpm = 120;
   
+  // Events into the audio thread
+  KoeKit::ParamId kickEvent = KoeKit::INVALID_PARAM;
+  KoeKit::ParamId snareEvent = KoeKit::INVALID_PARAM;
+  KoeKit::ParamId hihatEvent = KoeKit::INVALID_PARAM;
+  
   // Pattern storage (16 steps)
   bool kickPattern[16] = {1,0,0,0, 1,0,1,0, 1,0,0,0, 1,0,0,0};
   bool snarePattern[16] = {0,0,0,0, 1,0,0,0, 0,0,0,0, 1,0,0,0};
@@ -149,6 +158,20 @@ private:
 public:
   DrumMachine() {}
   
+  // Register the voice triggers (call from setup())
+  void begin() {
+    kickEvent = KoeKit::addEvent([this](float) { kick.trigger(); });
+    snareEvent = KoeKit::addEvent([this](float) { snare.trigger(); });
+    hihatEvent = KoeKit::addEvent([this](float open) {
+      if (open > 0.0f) {
+        hihat.triggerOpen();
+      } else {
+        hihat.triggerClosed();
+      }
+    });
+    nextStepFrame = KoeKit::getFrameTime() + LOOKAHEAD_FRAMES;
+  }
+  
   void setBPM(int newBPM) {
     bpm = constrain(newBPM, 60, 200);
   }
@@ -158,32 +181,38 @@ public:
   }
   
   void update() {
-    unsigned long stepInterval = 60000 / (bpm * 4);  // 16th notes
-    
-    if (millis() - lastStepTime >= stepInterval) {
-      playStep(currentStep);
+    // Schedule every step that starts within the lookahead window
+    const uint32_t now = KoeKit::getFrameTime();
+    while (static_cast<int32_t>(nextStepFrame - now) < static_cast<int32_t>(LOOKAHEAD_FRAMES)) {
+      playStep(currentStep, nextStepFrame);
       currentStep = (currentStep + 1) % 16;
-      lastStepTime = millis();
+      
+      // 16th notes; carry the remainder so the tempo never drifts
+      const uint32_t perMinute = KoeKit::SAMPLE_RATE * 60;
+      const uint32_t stepsPerMinute = bpm * 4;
+      stepRemainder += perMinute % stepsPerMinute;
+      nextStepFrame += perMinute / stepsPerMinute + stepRemainder / stepsPerMinute;
+      stepRemainder %= stepsPerMinute;
     }
   }
   
-  void playStep(int step) {
+  void playStep(int step, uint32_t frame) {
     if (kickPattern[step]) {
-      kick.trigger();
+      KoeKit::sendEventAt(kickEvent, 1.0f, frame);
     }
     if (snarePattern[step]) {
-      snare.trigger();
+      KoeKit::sendEventAt(snareEvent, 1.0f, frame);
     }
     if (hihatPattern[step]) {
-      hihat.triggerClosed();
+      KoeKit::sendEventAt(hihatEvent, 0.0f, frame);
     }
   }
   
-  // Manual triggers
-  void triggerKick() { kick.trigger(); }
-  void triggerSnare() { snare.trigger(); }
-  void triggerHiHat() { hihat.triggerClosed(); }
-  void triggerOpenHiHat() { hihat.triggerOpen(); }
+  // Manual triggers (play at the start of the next block)
+  void triggerKick() { KoeKit::sendEvent(kickEvent); }
+  void triggerSnare() { KoeKit::sendEvent(snareEvent); }
+  void triggerHiHat() { KoeKit::sendEvent(hihatEvent, 0.0f); }
+  void triggerOpenHiHat() { KoeKit::sendEvent(hihatEvent, 1.0f); }
   
   float process() {
     float output = 0.0f;
@@ -235,6 +264,7 @@ void setup() {
   KoeKit::setAudioCallback([]() -> float {
     return drumMachine.process();
   });
+  drumMachine.begin();
   
   Serial.println("Drum machine ready!");
   Serial.println("Automatic pattern playing...");
@@ -7,7 +7,8 @@
  * - Filter envelope for dynamic timbre changes
  * - LFO modulation
  * - Multiple oscillators with detuning
- * - Real-time parameter control
+ * - Real-time parameter control through the parameter queue
+ * - Skipping the render while no note is sounding
  * 
  * Hardware:
  * - RP2350A board
@@ -51,6 +52,12 @@ struct EnvelopeParams {
 EnvelopeParams ampParams = {0.02f, 0.3f, 0.6f, 0.8f};
 EnvelopeParams filterParams = {0.01f, 0.5f, 0.3f, 1.0f};
 
+// Messages from loop() to the audio thread
+KoeKit::ParamId gateEvent;
+KoeKit::ParamId cutoffParam;
+KoeKit::ParamId envAmountParam;
+KoeKit::ParamId lfoSpeedParam;
+
 void setup() {
   Serial.begin(115200);
   Serial.println("KoeKit Envelope Synthesizer");
@@ -58,6 +65,10 @@ void setup() {
   // Setup pins
   pinMode(TRIGGER_PIN, INPUT_PULLUP);
   
+  // The amplitude envelope comes last, so once it is idle the output is
+  // exact silence and the engine can skip the whole chain
+  KoeKit::setIdleCheck([] { return !ampEnvelope.isActive(); });
+  
   // Initialize KoeKit
   if (!KoeKit::begin(22050, 1)) {
     Serial.println("Failed to initialize KoeKit!");
@@ -87,6 +98,21 @@ void setup() {
   vibrato.setAmplitude(0.02f);  // Subtle vibrato
   vibrato.setWaveform(KoeKit::Envelope::LFO::Waveform::SINE);
   
+  // Envelopes, filter and LFO are only touched on the audio thread;
+  // loop() posts changes and the engine applies them between blocks
+  gateEvent = KoeKit::addEvent([](float gate) {
+    if (gate > 0.0f) {
+      ampEnvelope.noteOn();
+      filterEnvelope.noteOn();
+    } else {
+      ampEnvelope.noteOff();
+      filterEnvelope.noteOff();
+    }
+  });
+  cutoffParam = KoeKit::addParameter([](float value) { baseCutoff = value; });
+  envAmountParam = KoeKit::addParameter([](float value) { filterEnvAmount = value; });
+  lfoSpeedParam = KoeKit::addParameter([](float value) { vibrato.setFrequency(value); });
+  
   // Set audio callback
   KoeKit::setAudioCallback([]() -> float {
     return processSynthesis();
@@ -149,14 +175,12 @@ void handleNoteControl() {
   // Note on (button pressed)
   if (lastButtonState == HIGH && currentButtonState == LOW) {
     Serial.println("Note ON");
-    ampEnvelope.noteOn();
-    filterEnvelope.noteOn();
+    KoeKit::sendEvent(gateEvent, 1.0f);
   }
   // Note off (button released)
   else if (lastButtonState == LOW && currentButtonState == HIGH) {
     Serial.println("Note OFF");
-    ampEnvelope.noteOff();
-    filterEnvelope.noteOff();
+    KoeKit::sendEvent(gateEvent, 0.0f);
   }
   
   lastButtonState = currentButtonState;
@@ -171,20 +195,20 @@ void updateParametersFromPots() {
     // Filter cutoff control (A0)
     int cutoffPot = analogRead(FILTER_CUTOFF_PIN);
     if (cutoffPot > 10) {  // Only if pot is connected
-      baseCutoff = map(cutoffPot, 0, 1023, 200, 4000);
+      KoeKit::setParameter(cutoffParam, map(cutoffPot, 0, 1023, 200, 4000));
     }
     
     // Filter envelope amount control (A1)
     int envAmountPot = analogRead(FILTER_ENV_PIN);
     if (envAmountPot > 10) {
-      filterEnvAmount = map(envAmountPot, 0, 1023, 0, 3000);
+      KoeKit::setParameter(envAmountParam, map(envAmountPot, 0, 1023, 0, 3000));
     }
     
     // LFO speed control (A2)
     int lfoSpeedPot = analogRead(LFO_SPEED_PIN);
     if (lfoSpeedPot > 10) {
       float lfoFreq = map(lfoSpeedPot, 0, 1023, 10, 80) / 10.0f;  // 1.0 to 8.0 Hz
-      vibrato.setFrequency(lfoFreq);
+      KoeKit::setParameter(lfoSpeedParam, lfoFreq);
     }
     
     lastUpdate = millis();
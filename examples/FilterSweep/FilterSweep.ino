@@ -6,7 +6,7 @@
  * - State Variable Filter with high resonance
  * - Automatic filter frequency sweeping
  * - Multiple filter output modes
- * - Real-time parameter control
+ * - Real-time parameter control through the parameter queue
  * 
  * Hardware:
  * - RP2350A board
@@ -36,6 +36,8 @@ unsigned long lastModeChange = 0;
 
 // Resonance control
 const int RESONANCE_POT_PIN = A0;
+float resonance = 4.0f;                              // Audio thread only
+KoeKit::ParamId resonanceParam = KoeKit::INVALID_PARAM;
 
 const char* filterModeNames[] = {
   "Low-Pass",
@@ -64,7 +66,14 @@ void setup() {
   sawOsc.setAmplitude(0.6f);
   
   // Configure filter with high resonance
-  filter.setParams(cutoffFreq, 4.0f);  // High resonance for dramatic effect
+  filter.setParams(cutoffFreq, resonance);  // High resonance for dramatic effect
+  
+  // The filter is only touched on the audio thread; loop() posts new
+  // resonance values and the engine applies the latest one between blocks
+  resonanceParam = KoeKit::addParameter([](float value) {
+    resonance = value;
+    filter.setParams(cutoffFreq, resonance);
+  });
   
   // Set audio callback
   KoeKit::setAudioCallback([]() -> float {
@@ -146,11 +155,10 @@ void updateResonanceFromPot() {
     
     if (potValue > 10) {  // Only if pot is connected
       // Map potentiometer to resonance range (0.5 to 8.0)
-      float resonance = map(potValue, 0, 1023, 50, 800) / 100.0f;
-      filter.setParams(cutoffFreq, resonance);
+      KoeKit::setParameter(resonanceParam, map(potValue, 0, 1023, 50, 800) / 100.0f);
     } else {
       // Use default resonance if no pot connected
-      filter.setParams(cutoffFreq, 4.0f);
+      KoeKit::setParameter(resonanceParam, 4.0f);
     }
     
     lastRead = millis();
@@ -0,0 +1,103 @@
+/**
+ * @file InputFilter.ino
+ * @brief Runs KoeKit's filter on an audio input as an effects unit
+ *
+ * This example shows:
+ * - Capturing audio from the ADC with DMA
+ * - A process callback that filters the captured input
+ * - Switching between effect and bypass with a crossfade
+ *
+ * Hardware:
+ * - RP2350A board
+ * - Line-level audio biased to mid-supply (1.65V) on GPIO 26 (ADC0)
+ * - Speaker or line out connected to pin 1
+ * - Optional button on pin 2 to toggle bypass
+ *
+ * analogRead() cannot be used while the ADC is capturing audio.
+ */
+
+#include <KoeKit.h>
+
+// Effect: resonant low-pass swept by a slow LFO
+KoeKit::Filter::StateVariable filter;
+float lfoPhase = 0.0f;
+const float LFO_RATE = 0.5f;          // Hz
+const float MIN_CUTOFF = 300.0f;
+const float MAX_CUTOFF = 2500.0f;
+
+// Bypass switching
+const int BYPASS_BUTTON_PIN = 2;
+bool lastButtonState = HIGH;
+bool bypassed = false;
+
+void processFilter(const float* in, float* out, size_t frames, void*) {
+  // One cutoff update per block is plenty for a 0.5 Hz sweep
+  lfoPhase += LFO_RATE * frames / KoeKit::SAMPLE_RATE_F;
+  if (lfoPhase >= 1.0f) {
+    lfoPhase -= 1.0f;
+  }
+  const float sweep = 0.5f - 0.5f * cosf(KoeKit::TWO_PI * lfoPhase);
+  filter.setCutoff(MIN_CUTOFF + (MAX_CUTOFF - MIN_CUTOFF) * sweep);
+
+  for (size_t i = 0; i < frames; ++i) {
+    filter.process(in[i]);
+    out[i] = filter.getLowPass();
+  }
+}
+
+void processBypass(const float* in, float* out, size_t frames, void*) {
+  for (size_t i = 0; i < frames; ++i) {
+    out[i] = in[i];
+  }
+}
+
+void setup() {
+  Serial.begin(115200);
+  Serial.println("KoeKit Input Filter Example");
+
+  pinMode(BYPASS_BUTTON_PIN, INPUT_PULLUP);
+
+  filter.setParams(MIN_CUTOFF, 3.0f);
+
+  // Capture from GPIO 26 at the engine's rate
+  KoeKit::ADCAudioInput& input = KoeKit::ADCAudioInput::getInstance();
+  input.setInputPin(26);
+  KoeKit::setInput(&input);
+
+  // Fade between effect and bypass instead of cutting
+  KoeKit::setCrossfade(0.02f);
+  KoeKit::setProcessCallback(processFilter);
+
+  if (!KoeKit::begin(22050, 1)) {
+    Serial.println("Failed to initialize KoeKit!");
+    while (1);
+  }
+
+  Serial.println("Input filter running...");
+  Serial.println("Button on pin 2 toggles bypass");
+}
+
+void loop() {
+  bool currentButtonState = digitalRead(BYPASS_BUTTON_PIN);
+  if (lastButtonState == HIGH && currentButtonState == LOW) {
+    bypassed = !bypassed;
+    KoeKit::setProcessCallback(bypassed ? processBypass : processFilter);
+    Serial.println(bypassed ? "Bypass" : "Filter");
+  }
+  lastButtonState = currentButtonState;
+
+  // Report capture health periodically
+  static unsigned long lastPrint = 0;
+  if (millis() - lastPrint > 2000) {
+    KoeKit::ADCAudioInput& input = KoeKit::ADCAudioInput::getInstance();
+    Serial.print("Input underruns: ");
+    Serial.print(input.getUnderrunCount());
+    Serial.print(", overruns: ");
+    Serial.print(input.getOverrunCount());
+    Serial.print(", skipped: ");
+    Serial.println(input.getSkipCount());
+    lastPrint = millis();
+  }
+
+  delay(20);
+}
@@ -0,0 +1,324 @@
+/**
+ * @file benchmark.cpp
+ * @brief Host micro-benchmarks for KoeKit DSP kernels
+ *
+ * Times each kernel over the same input and prints nanoseconds per sample.
+ * Absolute numbers are for the host CPU; compare cases against each other.
+ *
+ * Build and run (from the library root):
+ *   g++ -std=c++17 -O2 -Isrc extras/host/benchmark.cpp \
+ *       src/core/audio_engine.cpp src/core/offline_renderer.cpp -o benchmark
+ *   ./benchmark
+ */
+
+#include <KoeKit.h>
+#include <wavetables/bandlimited.h>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+constexpr size_t FRAMES = KoeKit::BLOCK_SIZE;
+constexpr size_t ITERATIONS = 200000;
+
+// Keeps results observable so the optimizer cannot drop the work
+volatile uint32_t sink;
+
+// Forces inputs to be reread on every iteration
+inline void clobber() {
+  asm volatile("" ::: "memory");
+}
+
+template<typename F>
+void bench(const char* name, F&& kernel) {
+  kernel();  // Warm up
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < ITERATIONS; ++i) {
+    kernel();
+    clobber();
+  }
+  const auto stop = std::chrono::steady_clock::now();
+  const double ns = std::chrono::duration<double, std::nano>(stop - start).count();
+  std::printf("  %-32s %8.3f ns/sample\n", name, ns / (ITERATIONS * FRAMES));
+}
+
+//=============================================================================
+// Float to PWM conversion
+//=============================================================================
+
+void benchPWMConvert() {
+  std::printf("Float to PWM conversion (%zu-sample blocks)\n", FRAMES);
+
+  std::vector<float> input(FRAMES);
+  std::vector<uint16_t> output(FRAMES);
+  KoeKit::NoiseGenerator noise;
+  noise.setAmplitude(0.9f);
+  for (auto& x : input) {
+    x = noise.process();
+  }
+
+  bench("PWM::fromSample per sample", [&] {
+    for (size_t i = 0; i < FRAMES; ++i) {
+      output[i] = KoeKit::PWM::fromSample(input[i]);
+    }
+    sink = output[FRAMES - 1];
+  });
+
+  KoeKit::PWM::BlockConverter converter;
+  bench("BlockConverter", [&] {
+    sink = converter.convert(input.data(), output.data(), FRAMES) + output[0];
+  });
+
+  converter.setDither(true);
+  bench("BlockConverter + dither", [&] {
+    sink = converter.convert(input.data(), output.data(), FRAMES) + output[0];
+  });
+
+  converter.setDCBlock(true);
+  bench("BlockConverter + dither + DC", [&] {
+    sink = converter.convert(input.data(), output.data(), FRAMES) + output[0];
+  });
+}
+
+//=============================================================================
+// Wavetable lookup
+//=============================================================================
+
+void benchWavetableLookup() {
+  std::printf("Wavetable lookup, %zu-sample table at 440 Hz\n", KoeKit::WAVETABLE_SIZE);
+
+  const auto& table = KoeKit::Wavetables::Basic::SAW;
+  std::vector<float> output(FRAMES);
+  constexpr float SIZE = static_cast<float>(KoeKit::WAVETABLE_SIZE);
+
+  // The float path as the oscillator used it: wrapped float phase scaled
+  // to an index, then wrap loops, modulo and a divide in the lookup
+  double float_phase = 0.0;
+  const double float_increment = 440.0 / KoeKit::SAMPLE_RATE;
+  bench("Float index getInterpolated()", [&] {
+    for (size_t i = 0; i < FRAMES; ++i) {
+      float_phase += float_increment;
+      if (float_phase >= 1.0) {
+        float_phase -= 1.0;
+      }
+      output[i] = table.getInterpolated(static_cast<float>(float_phase) * SIZE);
+    }
+    sink = static_cast<uint32_t>(output[0] * 1000.0f);
+  });
+
+  // Integer phase: top bits index, next bits interpolate, overflow wraps
+  uint32_t phase = 0;
+  const auto increment = static_cast<uint32_t>(440.0 / KoeKit::SAMPLE_RATE * 4294967296.0);
+  bench("Fixed phase lookupLinear()", [&] {
+    for (size_t i = 0; i < FRAMES; ++i) {
+      phase += increment;
+      output[i] = table.lookupLinear(phase);
+    }
+    sink = static_cast<uint32_t>(output[0] * 1000.0f);
+  });
+
+  bench("Fixed phase lookupCubic()", [&] {
+    for (size_t i = 0; i < FRAMES; ++i) {
+      phase += increment;
+      output[i] = table.lookupCubic(phase);
+    }
+    sink = static_cast<uint32_t>(output[0] * 1000.0f);
+  });
+
+  bench("Fixed phase lookupNearest()", [&] {
+    for (size_t i = 0; i < FRAMES; ++i) {
+      phase += increment;
+      output[i] = table.lookupNearest(phase);
+    }
+    sink = static_cast<uint32_t>(output[0] * 1000.0f);
+  });
+
+  // The same table re-stored as float (no conversion) and as 8-bit
+  static constexpr auto float_table = KoeKit::convertWavetable<KoeKit::FloatStorage>(table);
+  static constexpr auto int8_table = KoeKit::convertWavetable<KoeKit::Int8Storage>(table);
+
+  bench("Float storage getInterpolated()", [&] {
+    for (size_t i = 0; i < FRAMES; ++i) {
+      float_phase += float_increment;
+      if (float_phase >= 1.0) {
+        float_phase -= 1.0;
+      }
+      output[i] = float_table.getInterpolated(static_cast<float>(float_phase) * SIZE);
+    }
+    sink = static_cast<uint32_t>(output[0] * 1000.0f);
+  });
+
+  bench("Float storage lookupLinear()", [&] {
+    for (size_t i = 0; i < FRAMES; ++i) {
+      phase += increment;
+      output[i] = float_table.lookupLinear(phase);
+    }
+    sink = static_cast<uint32_t>(output[0] * 1000.0f);
+  });
+
+  bench("Int8 storage lookupLinear()", [&] {
+    for (size_t i = 0; i < FRAMES; ++i) {
+      phase += increment;
+      output[i] = int8_table.lookupLinear(phase);
+    }
+    sink = static_cast<uint32_t>(output[0] * 1000.0f);
+  });
+
+  KoeKit::Oscillator osc(table);
+  osc.setFrequency(440.0f);
+  bench("Oscillator::process()", [&] {
+    for (size_t i = 0; i < FRAMES; ++i) {
+      output[i] = osc.process();
+    }
+    sink = static_cast<uint32_t>(output[0] * 1000.0f);
+  });
+}
+
+//=============================================================================
+// Symmetry-compressed wavetables
+//=============================================================================
+
+template<typename Table>
+void benchTableLookups(const char* name, const Table& table) {
+  std::vector<float> output(FRAMES);
+  uint32_t phase = 0;
+  const auto increment = static_cast<uint32_t>(440.0 / KoeKit::SAMPLE_RATE * 4294967296.0);
+  char label[64];
+
+  std::snprintf(label, sizeof(label), "%s lookupLinear()", name);
+  bench(label, [&] {
+    for (size_t i = 0; i < FRAMES; ++i) {
+      phase += increment;
+      output[i] = table.lookupLinear(phase);
+    }
+    sink = static_cast<uint32_t>(output[0] * 1000.0f);
+  });
+
+  std::snprintf(label, sizeof(label), "%s lookupCubic()", name);
+  bench(label, [&] {
+    for (size_t i = 0; i < FRAMES; ++i) {
+      phase += increment;
+      output[i] = table.lookupCubic(phase);
+    }
+    sink = static_cast<uint32_t>(output[0] * 1000.0f);
+  });
+}
+
+void benchSymmetricTables() {
+  using namespace KoeKit::Wavetables::Basic;
+  std::printf("Flat vs symmetry-compressed tables at 440 Hz (bytes: %zu flat, %zu quarter, %zu half)\n",
+              sizeof(SINE), sizeof(SINE_COMPACT), sizeof(SQUARE_COMPACT));
+
+  benchTableLookups("Flat SINE", SINE);
+  benchTableLookups("Quarter SINE", SINE_COMPACT);
+  benchTableLookups("Flat TRIANGLE", TRIANGLE);
+  benchTableLookups("Half TRIANGLE", TRIANGLE_COMPACT);
+}
+
+//=============================================================================
+// Polyphase resampling
+//=============================================================================
+
+void fillNoise(float* out, size_t frames, void* context) {
+  auto* noise = static_cast<KoeKit::NoiseGenerator*>(context);
+  for (size_t i = 0; i < frames * KoeKit::CHANNELS; ++i) {
+    out[i] = noise->process();
+  }
+}
+
+void benchResampler() {
+  std::printf("Resampler, 16 kHz to 48 kHz (per output sample)\n");
+
+  KoeKit::NoiseGenerator noise;
+  std::vector<float> output(FRAMES * KoeKit::CHANNELS);
+  const struct {
+    const char* name;
+    KoeKit::ResampleQuality quality;
+  } cases[] = {
+    {"Resampler FAST", KoeKit::ResampleQuality::FAST},
+    {"Resampler BALANCED", KoeKit::ResampleQuality::BALANCED},
+    {"Resampler BEST", KoeKit::ResampleQuality::BEST},
+  };
+
+  for (const auto& c : cases) {
+    KoeKit::Resampler resampler;
+    resampler.begin(16000, 48000, c.quality);
+    bench(c.name, [&] {
+      resampler.process(output.data(), FRAMES, &fillNoise, &noise);
+      sink = static_cast<uint32_t>(output[0] * 1000.0f);
+    });
+  }
+}
+
+//=============================================================================
+// Oversampled rendering
+//=============================================================================
+
+KoeKit::Oscillator saw = KoeKit::createOscillator(KoeKit::Wavetables::Basic::Waveform::SAW);
+
+void renderSaw(float* out, size_t frames, void*) {
+  for (size_t i = 0; i < frames; ++i) {
+    const float sample = saw.process();
+    for (size_t c = 0; c < KoeKit::CHANNELS; ++c) {
+      out[i * KoeKit::CHANNELS + c] = sample;
+    }
+  }
+}
+
+KoeKit::BandLimitedOscillator bandLimitedSaw(KoeKit::Wavetables::BandLimited::SAW);
+
+void renderBandLimitedSaw(float* out, size_t frames, void*) {
+  for (size_t i = 0; i < frames; ++i) {
+    const float sample = bandLimitedSaw.process();
+    for (size_t c = 0; c < KoeKit::CHANNELS; ++c) {
+      out[i * KoeKit::CHANNELS + c] = sample;
+    }
+  }
+}
+
+void benchOversampling() {
+  std::printf("Saw oscillator through the engine (per output sample)\n");
+
+  KoeKit::AudioEngine& engine = KoeKit::AudioEngine::getInstance();
+  std::vector<float> output(FRAMES * KoeKit::CHANNELS);
+  const struct {
+    const char* name;
+    KoeKit::Oversampling factor;
+  } cases[] = {
+    {"Oversampling X1", KoeKit::Oversampling::X1},
+    {"Oversampling X2", KoeKit::Oversampling::X2},
+    {"Oversampling X4", KoeKit::Oversampling::X4},
+  };
+
+  engine.setBlockCallback(&renderSaw);
+  for (const auto& c : cases) {
+    engine.setOversampling(c.factor);
+    saw.setSampleRate(KoeKit::SAMPLE_RATE_F * static_cast<float>(c.factor));
+    saw.setFrequency(440.0f);
+    bench(c.name, [&] {
+      engine.render(output.data(), FRAMES);
+      sink = static_cast<uint32_t>(output[0] * 1000.0f);
+    });
+  }
+  engine.setOversampling(KoeKit::Oversampling::X1);
+
+  // Alias-free without oversampling; 440 Hz sits mid-crossfade (two lookups)
+  engine.setBlockCallback(&renderBandLimitedSaw);
+  bandLimitedSaw.setFrequency(440.0f);
+  bench("Band-limited saw, X1", [&] {
+    engine.render(output.data(), FRAMES);
+    sink = static_cast<uint32_t>(output[0] * 1000.0f);
+  });
+}
+
+} // namespace
+
+int main() {
+  benchPWMConvert();
+  benchWavetableLookup();
+  benchSymmetricTables();
+  benchResampler();
+  benchOversampling();
+  return 0;
+}
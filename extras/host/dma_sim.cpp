@@ -0,0 +1,247 @@
+/**
+ * @file dma_sim.cpp
+ * @brief Checks the DMA PWM output's ping-pong buffer handling on a host
+ *
+ * Runs DMAPWMAudioOutput on SimulatedDMATransport, which plays one queued
+ * block per consumeBlock() and raises its completion the way the DMA
+ * interrupt would. The source stamps every block with a sequence number,
+ * so each played block can be traced back to the pull that rendered it.
+ * Checks that:
+ *   - blocks play in the order they were rendered, none lost or repeated
+ *   - every ring block is released exactly once (the ring stays full and
+ *     its blocks are played in rotation)
+ *   - a starved output (source removed) drains the ring, then plays
+ *     silence and counts one underrun per silent block, and recovers
+ *
+ * Build and run (from the library root):
+ *   g++ -std=c++17 -O2 -Isrc extras/host/dma_sim.cpp \
+ *       src/core/audio_engine.cpp src/core/offline_renderer.cpp -o dma_sim
+ *   ./dma_sim
+ */
+
+#include <KoeKit.h>
+#include <array>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+using KoeKit::DMAPWMAudioOutput;
+
+constexpr size_t BLOCK_FRAMES = DMAPWMAudioOutput::BLOCK_FRAMES;
+constexpr size_t NUM_BLOCKS = DMAPWMAudioOutput::NUM_BLOCKS;
+constexpr uint32_t SEQUENCES = 180;     // Distinct block stamps before they repeat
+constexpr uint32_t SILENT = UINT32_MAX;
+constexpr uint32_t UNKNOWN = UINT32_MAX - 1;
+
+int failures = 0;
+
+void check(bool ok, const char* what) {
+  std::printf("  %-56s %s\n", what, ok ? "ok" : "FAILED");
+  if (!ok) {
+    ++failures;
+  }
+}
+
+//=============================================================================
+// Stamped source
+//=============================================================================
+
+// Constant level per block, never exactly zero (that would be converted
+// as digital silence)
+float stampLevel(uint32_t sequence) {
+  return -0.895f + static_cast<float>(sequence % SEQUENCES) * 0.01f;
+}
+
+uint32_t pulls = 0;
+
+void renderStamped(float* out, size_t frames, void*) {
+  const float level = stampLevel(pulls++);
+  std::fill(out, out + frames * KoeKit::CHANNELS, level);
+}
+
+/**
+ * Maps played PWM levels back to block stamps, through a converter with
+ * the output's settings (no dither, no DC blocker).
+ */
+class StampDecoder {
+ private:
+  std::array<uint16_t, SEQUENCES> levels_ = {};
+
+ public:
+  StampDecoder() {
+    KoeKit::PWM::BlockConverter converter;
+    for (uint32_t s = 0; s < SEQUENCES; ++s) {
+      const float level = stampLevel(s);
+      converter.convert(&level, &levels_[s], 1);
+    }
+  }
+
+  uint32_t decode(const uint16_t* block) const {
+    for (size_t i = 1; i < BLOCK_FRAMES; ++i) {
+      if (block[i] != block[0]) {
+        return UNKNOWN;     // Torn block
+      }
+    }
+    if (block[0] == KoeKit::PWM::CENTER) {
+      return SILENT;
+    }
+    for (uint32_t s = 0; s < SEQUENCES; ++s) {
+      if (levels_[s] == block[0]) {
+        return s;
+      }
+    }
+    return UNKNOWN;
+  }
+};
+
+//=============================================================================
+// Recording transport
+//=============================================================================
+
+/**
+ * Notes which buffer each half was given, so the ring blocks being played
+ * can be told apart from the output's silence block.
+ */
+class RecordingTransport : public KoeKit::SimulatedDMATransport {
+ private:
+  const uint16_t* halves_[2] = {nullptr, nullptr};
+  uint8_t playing_ = 0;
+
+ public:
+  void start(const uint16_t* first, const uint16_t* second) override {
+    halves_[0] = first;
+    halves_[1] = second;
+    playing_ = 0;
+    SimulatedDMATransport::start(first, second);
+  }
+
+  void queue(uint8_t half, const uint16_t* block) override {
+    halves_[half] = block;
+    SimulatedDMATransport::queue(half, block);
+  }
+
+  // Play one block; returns the buffer it came from
+  const uint16_t* play(uint16_t* out) {
+    const uint16_t* block = halves_[playing_];
+    playing_ ^= 1;
+    consumeBlock(out);
+    return block;
+  }
+};
+
+//=============================================================================
+// Checks
+//=============================================================================
+
+struct Played {
+  uint32_t stamp;
+  const uint16_t* buffer;
+};
+
+Played playOne(RecordingTransport& transport, const StampDecoder& decoder) {
+  std::array<uint16_t, BLOCK_FRAMES> levels = {};
+  const uint16_t* buffer = transport.play(levels.data());
+  return Played{decoder.decode(levels.data()), buffer};
+}
+
+void checkSteadyState(RecordingTransport& transport, const StampDecoder& decoder,
+                      uint32_t& next_stamp) {
+  constexpr int BLOCKS = 1000;
+  bool in_order = true;
+  bool ring_full = true;
+  bool rotates = true;
+  std::vector<const uint16_t*> buffers;
+
+  for (int i = 0; i < BLOCKS; ++i) {
+    const Played played = playOne(transport, decoder);
+    in_order = in_order && played.stamp == next_stamp % SEQUENCES;
+    ++next_stamp;
+    // One release and one render per completion: the ring holds every
+    // rendered block that has not finished playing
+    ring_full = ring_full && pulls == next_stamp + NUM_BLOCKS;
+    buffers.push_back(played.buffer);
+  }
+  for (size_t i = NUM_BLOCKS; i < buffers.size(); ++i) {
+    rotates = rotates && buffers[i] == buffers[i - NUM_BLOCKS];
+  }
+  for (size_t i = 1; i < NUM_BLOCKS; ++i) {
+    for (size_t j = 0; j < i; ++j) {
+      rotates = rotates && buffers[i] != buffers[j];
+    }
+  }
+
+  check(in_order, "blocks play in render order");
+  check(ring_full, "each played block is released once, ring stays full");
+  check(rotates, "ring blocks are played in rotation");
+}
+
+void checkStarvation(DMAPWMAudioOutput& output, RecordingTransport& transport,
+                     const StampDecoder& decoder, uint32_t& next_stamp) {
+  const uint32_t underruns_before = output.getUnderrunCount();
+  output.setSource(nullptr);
+
+  // The blocks already rendered still play, then silence
+  bool drains_in_order = true;
+  for (size_t i = 0; i < NUM_BLOCKS; ++i) {
+    drains_in_order = drains_in_order && playOne(transport, decoder).stamp == next_stamp % SEQUENCES;
+    ++next_stamp;
+  }
+  bool silent = true;
+  uint32_t silent_blocks = 0;
+  for (int i = 0; i < 64; ++i) {
+    silent = silent && playOne(transport, decoder).stamp == SILENT;
+    ++silent_blocks;
+  }
+  check(drains_in_order, "starved: rendered blocks drain in order");
+  check(silent, "starved: then silence");
+
+  // Back to rendering: the halves already queued with silence play out,
+  // then the stamps carry on from the last pull
+  output.setSource(&renderStamped);
+  next_stamp = pulls;
+  Played played = playOne(transport, decoder);
+  while (played.stamp == SILENT) {
+    ++silent_blocks;
+    played = playOne(transport, decoder);
+  }
+  bool recovers = played.stamp == next_stamp % SEQUENCES;
+  ++next_stamp;
+  for (int i = 0; i < 100; ++i) {
+    recovers = recovers && playOne(transport, decoder).stamp == next_stamp % SEQUENCES;
+    ++next_stamp;
+  }
+  check(output.getUnderrunCount() - underruns_before == silent_blocks,
+        "starved: one underrun per silent block");
+  check(recovers, "recovers in order once the source is back");
+}
+
+} // namespace
+
+int main() {
+  std::printf("DMA PWM output on a simulated transport, %zu blocks of %zu frames\n",
+              NUM_BLOCKS, BLOCK_FRAMES);
+
+  RecordingTransport transport;
+  StampDecoder decoder;
+  DMAPWMAudioOutput& output = DMAPWMAudioOutput::getInstance();
+  output.setTransport(transport);
+  output.setSource(&renderStamped);
+  if (!output.begin(KoeKit::SAMPLE_RATE)) {
+    std::printf("begin() failed\n");
+    return 1;
+  }
+  check(pulls == NUM_BLOCKS, "begin() renders the whole ring");
+
+  uint32_t next_stamp = 0;
+  checkSteadyState(transport, decoder, next_stamp);
+  check(output.getUnderrunCount() == 0, "no underruns while the source keeps up");
+  checkStarvation(output, transport, decoder, next_stamp);
+  checkSteadyState(transport, decoder, next_stamp);
+
+  output.end();
+  check(!transport.consumeBlock(), "end() stops the transport");
+
+  std::printf(failures == 0 ? "All checks passed\n" : "%d check(s) FAILED\n", failures);
+  return failures == 0 ? 0 : 1;
+}
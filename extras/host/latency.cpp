@@ -0,0 +1,190 @@
+/**
+ * @file latency.cpp
+ * @brief Event-to-sound latency harness on a simulated output clock
+ *
+ * Drives the engine from a simulated output that plays one frame per
+ * sample-clock tick and pulls blocks the way the real backends do. Each
+ * trial injects a trigger from "loop()" at a random point in the output
+ * cycle and counts ticks until the first non-silent sample is played.
+ * Prints the latency distribution for each output configuration next to
+ * the engine's own worst-case estimate, getLatencyFrames().
+ *
+ * Engine-side settings are compile-time; build once per configuration:
+ *   for b in 16 32 64; do
+ *     g++ -std=c++17 -O2 -Isrc -DKOEKIT_BLOCK_SIZE=$b extras/host/latency.cpp \
+ *         src/core/audio_engine.cpp src/core/offline_renderer.cpp -o latency
+ *     ./latency
+ *   done
+ *
+ * Render time is taken as zero, so these are the buffering latencies the
+ * configuration imposes; CPU load only adds to them.
+ */
+
+#include <KoeKit.h>
+#include <algorithm>
+#include <cstdio>
+#include <deque>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr uint32_t RATE = KoeKit::SAMPLE_RATE;
+constexpr int TRIALS = 2000;
+constexpr float THRESHOLD = 0.01f;
+
+//=============================================================================
+// Simulated output clock
+//=============================================================================
+
+/**
+ * Plays one frame per tick() from a queue of blocks. The queue starts
+ * full (like DMA priming) and a block is pulled every time one finishes
+ * playing. One block models the per-sample PWM output, which pulls a
+ * block when it runs dry; more blocks model the DMA ring.
+ */
+class SimulatedClockOutput : public KoeKit::AudioOutput {
+ private:
+  size_t block_frames_;
+  size_t queue_blocks_;
+  std::deque<std::vector<float>> queue_;
+  size_t play_pos_ = 0;
+  uint32_t sample_rate_ = 0;
+  bool active_ = false;
+
+  void pullBlock() {
+    std::vector<float> block(block_frames_ * KoeKit::CHANNELS);
+    pull(block.data(), block_frames_);
+    queue_.push_back(std::move(block));
+  }
+
+ public:
+  SimulatedClockOutput(size_t block_frames, size_t queue_blocks)
+      : block_frames_(block_frames), queue_blocks_(queue_blocks) {}
+
+  bool begin(uint32_t sample_rate) override {
+    sample_rate_ = sample_rate;
+    queue_.clear();
+    play_pos_ = 0;
+    active_ = true;
+    // Multi-block rings are primed before playback starts; the per-sample
+    // output pulls its first block on the first tick
+    for (size_t i = 1; i < queue_blocks_; ++i) {
+      pullBlock();
+    }
+    return true;
+  }
+
+  void end() override {
+    active_ = false;
+    clearSource();
+  }
+
+  bool isActive() const override { return active_; }
+  uint32_t getSampleRate() const override { return sample_rate_; }
+  size_t preferredBlockSize() const override { return block_frames_; }
+  uint32_t latencyFrames() const override {
+    return static_cast<uint32_t>(block_frames_ * queue_blocks_);
+  }
+
+  // Play the next frame (first channel)
+  float tick() {
+    if (play_pos_ == 0) {
+      pullBlock();
+    }
+    const float sample = queue_.front()[play_pos_ * KoeKit::CHANNELS];
+    if (++play_pos_ == block_frames_) {
+      queue_.pop_front();
+      play_pos_ = 0;
+    }
+    return sample;
+  }
+};
+
+//=============================================================================
+// Trigger
+//=============================================================================
+
+float level = 0.0f;             // Audio thread only
+KoeKit::ParamId trigger = KoeKit::INVALID_PARAM;
+
+void renderLevel(float* out, size_t frames, void*) {
+  std::fill(out, out + frames * KoeKit::CHANNELS, level);
+}
+
+struct Config {
+  const char* name;
+  size_t block_frames;
+  size_t queue_blocks;
+  KoeKit::Oversampling oversampling;
+};
+
+void measure(const Config& config, std::mt19937& rng) {
+  KoeKit::AudioEngine& engine = KoeKit::AudioEngine::getInstance();
+  SimulatedClockOutput output(config.block_frames, config.queue_blocks);
+  std::uniform_int_distribution<size_t> phase(0, 4 * config.block_frames * config.queue_blocks);
+  std::vector<uint32_t> latencies;
+  latencies.reserve(TRIALS);
+
+  engine.setOversampling(config.oversampling);
+  uint32_t estimate = 0;
+  for (int trial = 0; trial < TRIALS; ++trial) {
+    level = 0.0f;
+    engine.begin(output, RATE);
+    engine.setBlockCallback(&renderLevel);
+    estimate = engine.getLatencyFrames();
+
+    // Run to a random point in the output cycle, then trigger from "loop()"
+    for (size_t i = phase(rng) + 8 * config.block_frames; i > 0; --i) {
+      output.tick();
+    }
+    KoeKit::sendEvent(trigger);
+
+    uint32_t ticks = 1;
+    while (output.tick() < THRESHOLD) {
+      ++ticks;
+    }
+    latencies.push_back(ticks);
+    engine.end();
+  }
+  engine.setOversampling(KoeKit::Oversampling::X1);
+
+  std::sort(latencies.begin(), latencies.end());
+  double sum = 0.0;
+  for (uint32_t frames : latencies) {
+    sum += frames;
+  }
+  const auto ms = [](double frames) { return 1000.0 * frames / RATE; };
+  std::printf("  %-28s %7.2f %7.2f %7.2f %7.2f %7.2f %9.2f\n", config.name,
+              ms(latencies.front()), ms(sum / latencies.size()),
+              ms(latencies[latencies.size() / 2]),
+              ms(latencies[latencies.size() * 99 / 100]),
+              ms(latencies.back()), ms(estimate));
+}
+
+} // namespace
+
+int main() {
+  trigger = KoeKit::addEvent([](float) { level = 1.0f; });
+
+  std::printf("Event-to-sound latency, %u Hz, BLOCK_SIZE %zu (ms)\n", RATE, KoeKit::BLOCK_SIZE);
+  std::printf("  %-28s %7s %7s %7s %7s %7s %9s\n", "output", "min", "mean", "p50", "p99", "max",
+              "estimate");
+
+  const Config configs[] = {
+    {"per-sample PWM", KoeKit::BLOCK_SIZE, 1, KoeKit::Oversampling::X1},
+    {"per-sample PWM, 2x oversample", KoeKit::BLOCK_SIZE, 1, KoeKit::Oversampling::X2},
+    {"DMA 2 x 32", 32, 2, KoeKit::Oversampling::X1},
+    {"DMA 4 x 32", 32, 4, KoeKit::Oversampling::X1},
+    {"DMA 8 x 32", 32, 8, KoeKit::Oversampling::X1},
+    {"DMA 2 x 64", 64, 2, KoeKit::Oversampling::X1},
+    {"DMA 4 x 64", 64, 4, KoeKit::Oversampling::X1},
+    {"DMA 4 x 128", 128, 4, KoeKit::Oversampling::X1},
+  };
+
+  std::mt19937 rng(1);
+  for (const Config& config : configs) {
+    measure(config, rng);
+  }
+  return 0;
+}
@@ -0,0 +1,46 @@
+/**
+ * @file render_patch.cpp
+ * @brief Render a KoeKit patch to a WAV file on a desktop host
+ * 
+ * Uses the same audio callback as a sketch, but pulls samples from the
+ * engine as fast as the host allows instead of from the timer interrupt.
+ * Handy for bouncing presets, regression renders and profiling DSP code.
+ * 
+ * Build and run (from the library root):
+ *   g++ -std=c++17 -O2 -Isrc extras/host/render_patch.cpp \
+ *       src/core/audio_engine.cpp src/core/offline_renderer.cpp -o render_patch
+ *   ./render_patch patch.wav 10
+ */
+
+#include <KoeKit.h>
+#include <cstdio>
+#include <cstdlib>
+
+KoeKit::Oscillator osc(KoeKit::Wavetables::Basic::SAW);
+KoeKit::Envelope::ADSR env;
+
+int main(int argc, char** argv) {
+  const char* path = argc > 1 ? argv[1] : "patch.wav";
+  const float seconds = argc > 2 ? std::strtof(argv[2], nullptr) : 10.0f;
+  
+  osc.setFrequency(110.0f);
+  osc.setAmplitude(0.5f);
+  env.setADSR(0.01f, 0.2f, 0.6f, 0.5f);
+  env.noteOn();
+  
+  // Same callback a sketch would pass to setAudioCallback()
+  KoeKit::setAudioCallback([]() -> float {
+    return env.process(osc.process());
+  });
+  
+  const auto result = KoeKit::OfflineRenderer::renderToWav(path, seconds);
+  if (!result.ok) {
+    std::fprintf(stderr, "Failed to write %s\n", path);
+    return 1;
+  }
+  
+  std::printf("%s: %u frames in %.3f s (%.0fx real time)\n",
+              path, static_cast<unsigned>(result.frames),
+              result.wall_seconds, result.realtime_factor);
+  return 0;
+}
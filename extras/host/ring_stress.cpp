@@ -0,0 +1,208 @@
+/**
+ * @file ring_stress.cpp
+ * @brief Two-thread stress test of the lock-free rings
+ *
+ * Runs a producer and a consumer std::thread against BlockRing (the
+ * render ring between core1 and the output, the DMA ring) and SPSCQueue
+ * (parameter messages, telemetry). Every block and record carries its
+ * sequence number, and the consumer checks that each one arrives whole,
+ * once and in order while the ring indices wrap millions of times. Both
+ * sides stall at random, so the ring is seen empty, full and in between.
+ *
+ * Build and run (from the library root):
+ *   g++ -std=c++17 -O2 -pthread -Isrc extras/host/ring_stress.cpp -o ring_stress
+ *   ./ring_stress [blocks]
+ *
+ * Under ThreadSanitizer (use fewer blocks, it runs much slower):
+ *   g++ -std=c++17 -O1 -g -fsanitize=thread -Isrc extras/host/ring_stress.cpp -o ring_stress
+ *   ./ring_stress 200000
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include "core/block_ring.h"
+#include "core/spsc_queue.h"
+
+namespace {
+
+constexpr size_t BLOCK_FRAMES = 32;
+constexpr size_t NUM_BLOCKS = 4;
+constexpr size_t QUEUE_CAPACITY = 8;
+
+using Ring = KoeKit::BlockRing<uint32_t, BLOCK_FRAMES, NUM_BLOCKS>;
+
+/**
+ * Spins for a random, mostly zero, number of iterations so the two
+ * threads keep changing which one is ahead.
+ */
+class Stall {
+ private:
+  std::minstd_rand rng_;
+
+ public:
+  explicit Stall(uint32_t seed) : rng_(seed) {}
+
+  void operator()() {
+    const uint32_t r = rng_();
+    if ((r & 7) != 0) {
+      return;
+    }
+    for (volatile uint32_t i = (r >> 8) & 255; i > 0; --i) {
+    }
+    if ((r & 0xF00) == 0) {
+      std::this_thread::yield();
+    }
+  }
+};
+
+//=============================================================================
+// BlockRing
+//=============================================================================
+
+struct RingResult {
+  uint64_t errors = 0;
+  uint64_t peeked = 0;
+  uint32_t underruns = 0;
+  uint32_t overruns = 0;
+};
+
+RingResult stressBlockRing(uint32_t blocks) {
+  static Ring ring;
+  ring.reset();
+  RingResult result;
+
+  // Producer: fills in place, like the render core, waiting when full
+  std::thread producer([blocks] {
+    Stall stall(1);
+    for (uint32_t seq = 0; seq < blocks; ++seq) {
+      while (ring.writable() == 0) {
+        std::this_thread::yield();
+      }
+      uint32_t* block = ring.acquireWrite();
+      for (size_t i = 0; i < BLOCK_FRAMES; ++i) {
+        block[i] = seq * BLOCK_FRAMES + static_cast<uint32_t>(i);
+      }
+      stall();
+      ring.commitWrite();
+    }
+  });
+
+  // Consumer: plays blocks in place; an empty ring is an underrun, retried
+  Stall stall(2);
+  for (uint32_t seq = 0; seq < blocks; ++seq) {
+    const uint32_t* block = ring.acquireRead();
+    while (block == nullptr) {
+      std::this_thread::yield();
+      block = ring.acquireRead();
+    }
+    for (size_t i = 0; i < BLOCK_FRAMES; ++i) {
+      if (block[i] != seq * BLOCK_FRAMES + static_cast<uint32_t>(i)) {
+        ++result.errors;
+      }
+    }
+    // The DMA output looks one block ahead without releasing
+    if (const uint32_t* next = ring.peekRead(1)) {
+      ++result.peeked;
+      if (next[0] != (seq + 1) * BLOCK_FRAMES) {
+        ++result.errors;
+      }
+    }
+    stall();
+    ring.releaseRead();
+  }
+  producer.join();
+
+  if (ring.readable() != 0) {
+    ++result.errors;
+  }
+  result.underruns = ring.underruns();
+  result.overruns = ring.overruns();
+  return result;
+}
+
+//=============================================================================
+// SPSCQueue
+//=============================================================================
+
+struct Record {
+  uint32_t seq;
+  uint32_t inverse;     // ~seq: catches a record read while half written
+};
+
+struct QueueResult {
+  uint64_t errors = 0;
+  uint64_t retries = 0;
+  uint32_t dropped = 0;
+};
+
+QueueResult stressQueue(uint32_t records) {
+  static KoeKit::SPSCQueue<Record, QUEUE_CAPACITY> queue;
+  queue.reset();
+  QueueResult result;
+  uint64_t retries = 0;
+
+  // Producer: a full queue rejects the push; retry, so none is lost
+  std::thread producer([records, &retries] {
+    Stall stall(3);
+    for (uint32_t seq = 0; seq < records; ++seq) {
+      while (!queue.push(Record{seq, ~seq})) {
+        ++retries;
+        std::this_thread::yield();
+      }
+      stall();
+    }
+  });
+
+  Stall stall(4);
+  for (uint32_t seq = 0; seq < records;) {
+    Record record;
+    if (!queue.pop(record)) {
+      std::this_thread::yield();
+      continue;
+    }
+    if (record.seq != seq || record.inverse != ~seq) {
+      ++result.errors;
+    }
+    ++seq;
+    stall();
+  }
+  producer.join();
+
+  if (queue.size() != 0) {
+    ++result.errors;
+  }
+  result.retries = retries;
+  result.dropped = queue.dropped();
+  // Every rejected push is counted as a drop
+  if (result.dropped != static_cast<uint32_t>(result.retries)) {
+    ++result.errors;
+  }
+  return result;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const uint32_t blocks = argc > 1 ? static_cast<uint32_t>(std::strtoul(argv[1], nullptr, 10))
+                                   : 4000000;
+
+  std::printf("BlockRing<%zu x %zu>: %u blocks (%u index wraps)\n", NUM_BLOCKS, BLOCK_FRAMES,
+              blocks, static_cast<uint32_t>(blocks / NUM_BLOCKS));
+  const RingResult ring = stressBlockRing(blocks);
+  std::printf("  errors %llu, look-aheads %llu, underruns %u, overruns %u\n",
+              static_cast<unsigned long long>(ring.errors),
+              static_cast<unsigned long long>(ring.peeked), ring.underruns, ring.overruns);
+
+  std::printf("SPSCQueue<%zu>: %u records\n", QUEUE_CAPACITY, blocks);
+  const QueueResult queue = stressQueue(blocks);
+  std::printf("  errors %llu, full-queue retries %llu, dropped %u\n",
+              static_cast<unsigned long long>(queue.errors),
+              static_cast<unsigned long long>(queue.retries), queue.dropped);
+
+  // A producer that waits for room never overruns the block ring
+  const bool ok = ring.errors == 0 && ring.overruns == 0 && queue.errors == 0;
+  std::printf(ok ? "All checks passed\n" : "FAILED\n");
+  return ok ? 0 : 1;
+}
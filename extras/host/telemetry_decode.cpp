@@ -0,0 +1,53 @@
+/**
+ * @file telemetry_decode.cpp
+ * @brief Print a binary KoeKit telemetry dump as text
+ *
+ * A sketch drains the log in loop() and writes the raw 8-byte records to
+ * a serial port that carries nothing else:
+ *
+ *   KoeKit::TelemetryRecord records[16];
+ *   size_t n = KoeKit::drainTelemetry(records, 16);
+ *   Serial1.write(reinterpret_cast<const uint8_t*>(records), n * sizeof(records[0]));
+ *
+ * Capture the port to a file (or pipe it in) and decode it here:
+ *
+ *   g++ -std=c++17 -O2 -Isrc extras/host/telemetry_decode.cpp -o telemetry_decode
+ *   ./telemetry_decode capture.bin 22050
+ *   cat /dev/ttyACM1 | ./telemetry_decode - 22050
+ *
+ * The rate is the engine's render rate and turns frames into times.
+ */
+
+#include <KoeKit.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+int main(int argc, char** argv) {
+  const char* path = argc > 1 ? argv[1] : "-";
+  const uint32_t rate = argc > 2 ? static_cast<uint32_t>(std::strtoul(argv[2], nullptr, 10))
+                                 : KoeKit::SAMPLE_RATE;
+
+  FILE* in = std::strcmp(path, "-") == 0 ? stdin : std::fopen(path, "rb");
+  if (in == nullptr) {
+    std::fprintf(stderr, "Cannot open %s\n", path);
+    return 1;
+  }
+
+  // Records are little-endian on the RP2350 and on common hosts alike
+  KoeKit::TelemetryRecord record;
+  char line[96];
+  unsigned long count = 0;
+  while (std::fread(&record, sizeof(record), 1, in) == 1) {
+    KoeKit::formatTelemetry(record, rate, line, sizeof(line));
+    std::printf("%s\n", line);
+    std::fflush(stdout);
+    ++count;
+  }
+
+  if (in != stdin) {
+    std::fclose(in);
+  }
+  std::fprintf(stderr, "%lu records\n", count);
+  return 0;
+}
@@ -11,7 +11,9 @@
 #ifndef KOEKIT_H
 #define KOEKIT_H
 
+#if defined(ARDUINO)
 #include <Arduino.h>
+#endif
 #include <array>
 #include <cmath>
 #include <algorithm>
@@ -26,42 +28,39 @@
 #define KOEKIT_WAVETABLE_SIZE 1024
 #endif
 
-// Include core modules
-#include "core/wavetable_generator.h"
-#include "wavetables/basic.h"
-#include "core/oscillator.h"
-#include "core/filter.h"
-#include "core/envelope.h"
-#include "core/audio_output.h"
+#ifndef KOEKIT_BLOCK_SIZE
+#define KOEKIT_BLOCK_SIZE 32
+#endif
+
+#ifndef KOEKIT_CHANNELS
+#define KOEKIT_CHANNELS 1
+#endif
 
 /**
  * @namespace KoeKit
  * @brief Main namespace for all KoeKit functionality
+ *
+ * Core constants are declared before the modules that use them.
+ * The global functions (begin(), end(), ...) are declared in core/audio_output.h.
  */
 namespace KoeKit {
     constexpr uint32_t SAMPLE_RATE = KOEKIT_SAMPLE_RATE;
     constexpr size_t WAVETABLE_SIZE = KOEKIT_WAVETABLE_SIZE;
+    constexpr size_t BLOCK_SIZE = KOEKIT_BLOCK_SIZE;
+    constexpr size_t CHANNELS = KOEKIT_CHANNELS;     ///< Interleaved channels per frame
     constexpr float SAMPLE_RATE_F = static_cast<float>(SAMPLE_RATE);
     constexpr float TWO_PI = 6.28318530718f;
-    
-    /**
-     * @brief Initialize KoeKit audio system
-     * @param sample_rate Sample rate in Hz (default: 22050)
-     * @param output_pin PWM output pin (default: 1)
-     * @return true if initialization successful
-     */
-    bool begin(uint32_t sample_rate = SAMPLE_RATE, uint8_t output_pin = 1);
-    
-    /**
-     * @brief Shutdown KoeKit audio system
-     */
-    void end();
-    
-    /**
-     * @brief Get current sample rate
-     * @return Sample rate in Hz
-     */
-    uint32_t getSampleRate();
 }
 
+// Include core modules
+#include "core/wavetable_generator.h"
+#include "wavetables/basic.h"
+#include "core/oscillator.h"
+#include "core/filter.h"
+#include "core/envelope.h"
+#include "core/audio_output.h"
+#if !defined(ARDUINO)
+#include "core/offline_renderer.h"
+#endif
+
 #endif // KOEKIT_H
\ No newline at end of file
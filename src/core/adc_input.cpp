@@ -0,0 +1,139 @@
+/**
+ * @file adc_input.cpp
+ * @brief RP2350 ADC + DMA audio input for KoeKit
+ */
+
+#include "../KoeKit.h"
+
+#if defined(ARDUINO_ARCH_RP2040)
+
+#include "hardware/adc.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+
+namespace KoeKit {
+    
+    // Static member initialization
+    ADCAudioInput* ADCAudioInput::instance_ = nullptr;
+    
+    //=============================================================================
+    // ADCAudioInput Implementation
+    //=============================================================================
+    
+    ADCAudioInput& ADCAudioInput::getInstance() {
+        if (instance_ == nullptr) {
+            static ADCAudioInput instance;
+            instance_ = &instance;
+        }
+        return *instance_;
+    }
+    
+    bool ADCAudioInput::begin(uint32_t sample_rate) {
+        if (active_) {
+            end();
+        }
+        sample_rate_ = sample_rate;
+        resetCapture();
+        
+        adc_init();
+        uint round_robin = 0;
+        for (size_t c = 0; c < CHANNELS; ++c) {
+            adc_gpio_init(FIRST_PIN + inputs_[c]);
+            round_robin |= 1u << inputs_[c];
+        }
+        adc_select_input(inputs_[0]);
+        adc_set_round_robin(CHANNELS > 1 ? round_robin : 0);
+        
+        // One conversion every (1 + div) ADC clocks; DREQ at one sample
+        adc_fifo_setup(true, true, 1, false, false);
+        const float conversions = static_cast<float>(sample_rate) * CHANNELS;
+        adc_set_clkdiv(48000000.0f / conversions - 1.0f);
+        
+        // Two channels chained to each other fill alternate halves
+        for (int i = 0; i < 2; ++i) {
+            dma_channels_[i] = dma_claim_unused_channel(false);
+            if (dma_channels_[i] < 0) {
+                end();
+                return false;
+            }
+        }
+        for (int i = 0; i < 2; ++i) {
+            dma_channel_config c = dma_channel_get_default_config(dma_channels_[i]);
+            channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+            channel_config_set_read_increment(&c, false);
+            channel_config_set_write_increment(&c, true);
+            channel_config_set_dreq(&c, DREQ_ADC);
+            channel_config_set_chain_to(&c, dma_channels_[i ^ 1]);
+            dma_channel_configure(dma_channels_[i], &c, capture_[i].data(), &adc_hw->fifo,
+                                  BLOCK_SAMPLES, false);
+            dma_channel_set_irq1_enabled(dma_channels_[i], true);
+        }
+        
+        instance_ = this;
+        irq_add_shared_handler(DMA_IRQ_1, dmaISR, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+        irq_set_enabled(DMA_IRQ_1, true);
+        
+        active_ = true;
+        dma_channel_start(dma_channels_[0]);
+        adc_run(true);
+        return true;
+    }
+    
+    void ADCAudioInput::end() {
+        if (!active_ && dma_channels_[0] < 0 && dma_channels_[1] < 0) {
+            return;     // Never started
+        }
+        adc_run(false);
+        for (int i = 0; i < 2; ++i) {
+            if (dma_channels_[i] >= 0) {
+                dma_channel_set_irq1_enabled(dma_channels_[i], false);
+            }
+        }
+        for (int i = 0; i < 2; ++i) {
+            if (dma_channels_[i] >= 0) {
+                dma_channel_abort(dma_channels_[i]);
+                dma_channel_acknowledge_irq1(dma_channels_[i]);
+                dma_channel_unclaim(dma_channels_[i]);
+                dma_channels_[i] = -1;
+            }
+        }
+        irq_remove_handler(DMA_IRQ_1, dmaISR);
+        adc_fifo_drain();
+        adc_set_round_robin(0);
+        active_ = false;
+    }
+    
+    void ADCAudioInput::dmaISR() {
+        if (instance_ != nullptr) {
+            instance_->handleDMAInterrupt();
+        }
+    }
+    
+    void ADCAudioInput::handleDMAInterrupt() {
+        constexpr float SCALE = 1.0f / 2048.0f;
+        for (uint8_t half = 0; half < 2; ++half) {
+            const int channel = dma_channels_[half];
+            if (channel < 0 || !dma_channel_get_irq1_status(channel)) {
+                continue;
+            }
+            dma_channel_acknowledge_irq1(channel);
+            
+            // 12-bit unsigned around mid-scale to -1.0..1.0; a full ring
+            // counts as an overrun and the block is lost
+            if (float* block = acquireCapture()) {
+                const uint16_t* raw = capture_[half].data();
+                for (size_t i = 0; i < BLOCK_SAMPLES; ++i) {
+                    block[i] = (static_cast<float>(raw[i]) - 2048.0f) * SCALE;
+                }
+                commitCapture();
+            }
+            
+            // Re-armed, not triggered: the other channel chains into it
+            dma_channel_set_write_addr(channel, capture_[half].data(), false);
+            dma_channel_set_trans_count(channel, BLOCK_SAMPLES, false);
+        }
+    }
+
+} // namespace KoeKit
+
+#endif // ARDUINO_ARCH_RP2040
@@ -0,0 +1,209 @@
+#pragma once
+
+/**
+ * @file audio_backend.h
+ * @brief Block-oriented audio output backend interface for KoeKit
+ */
+
+#ifndef KOEKIT_AUDIO_BACKEND_H
+#define KOEKIT_AUDIO_BACKEND_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace KoeKit {
+    
+    namespace Detail {
+        /**
+         * @brief Check if a buffer holds digital silence (exact zeros)
+         *
+         * Stops at the first nonzero sample, so sound costs one compare.
+         */
+        inline bool isSilent(const float* samples, size_t count) noexcept {
+            for (size_t i = 0; i < count; ++i) {
+                if (samples[i] != 0.0f) {
+                    return false;
+                }
+            }
+            return true;
+        }
+    }
+    
+    /**
+     * @brief Audio output backend
+     *
+     * An output pulls audio from its source a block at a time and moves it
+     * to wherever it goes: a PWM pin, a DMA stream, a file or nowhere. The
+     * engine installs itself as the source in AudioEngine::begin(), and uses
+     * preferredBlockSize() and latencyFrames() to size its own buffering.
+     * Blocks hold `frames` frames of CHANNELS interleaved samples.
+     */
+    class AudioOutput {
+    public:
+        /**
+         * @brief Block source function type (same shape as BlockCallback)
+         */
+        using Source = void (*)(float* out, size_t frames, void* context);
+        
+        virtual ~AudioOutput() = default;
+        
+        /**
+         * @brief Start the output
+         * @param sample_rate Sample rate in Hz
+         * @return true if initialization successful
+         */
+        virtual bool begin(uint32_t sample_rate) = 0;
+        
+        /**
+         * @brief Stop the output
+         */
+        virtual void end() = 0;
+        
+        /**
+         * @brief Check if output is active
+         * @return true if audio output is running
+         */
+        virtual bool isActive() const = 0;
+        
+        /**
+         * @brief Get current sample rate
+         * @return Sample rate in Hz
+         */
+        virtual uint32_t getSampleRate() const = 0;
+        
+        /**
+         * @brief Frames requested from the source per pull
+         */
+        virtual size_t preferredBlockSize() const = 0;
+        
+        /**
+         * @brief Frames between a sample being rendered and it being heard
+         */
+        virtual uint32_t latencyFrames() const = 0;
+        
+        /**
+         * @brief Blocks replaced by silence inside the output
+         */
+        virtual uint32_t getUnderrunCount() const { return 0; }
+        
+        /**
+         * @brief Samples outside -1.0..1.0 that the output had to clip
+         */
+        uint32_t getClipCount() const {
+            return clipped_.load(std::memory_order_relaxed);
+        }
+        
+        /**
+         * @brief Restart clip counting
+         */
+        void resetClipCount() {
+            clipped_.store(0, std::memory_order_relaxed);
+        }
+        
+        /**
+         * @brief Set the function that renders audio blocks
+         * @param source Block render function
+         * @param context User pointer passed back to the source
+         */
+        void setSource(Source source, void* context = nullptr) noexcept {
+            source_context_ = context;
+            source_ = source;
+        }
+        
+    protected:
+        /**
+         * @brief Check if a source is set
+         */
+        bool hasSource() const noexcept { return source_ != nullptr; }
+        
+        /**
+         * @brief Fill a buffer from the source (silence if none is set)
+         * @param out Output buffer (frames * CHANNELS samples)
+         * @param frames Number of frames to render
+         */
+        void pull(float* out, size_t frames) {
+            if (source_) {
+                source_(out, frames, source_context_);
+            } else {
+                std::fill(out, out + frames * CHANNELS, 0.0f);
+            }
+        }
+        
+        /**
+         * @brief Count clipped samples (output context only)
+         * @param count Number of samples clipped
+         */
+        void countClip(uint32_t count = 1) {
+            clipped_.store(clipped_.load(std::memory_order_relaxed) + count,
+                           std::memory_order_relaxed);
+        }
+        
+        void clearSource() noexcept {
+            source_ = nullptr;
+            source_context_ = nullptr;
+        }
+        
+    private:
+        Source source_ = nullptr;
+        void* source_context_ = nullptr;
+        std::atomic<uint32_t> clipped_{0};
+    };
+    
+    /**
+     * @brief Output that renders and discards audio
+     *
+     * Nothing drives it: call pump() to render a number of frames as fast
+     * as possible. Measures DSP throughput without any output cost.
+     *
+     * @tparam BLOCK_FRAMES Frames pulled from the source at a time
+     */
+    template<size_t BLOCK_FRAMES = BLOCK_SIZE>
+    class NullAudioOutput : public AudioOutput {
+    private:
+        std::array<float, BLOCK_FRAMES * CHANNELS> block_ = {};
+        uint32_t sample_rate_ = 0;
+        bool active_ = false;
+        float last_sample_ = 0.0f;
+        
+    public:
+        bool begin(uint32_t sample_rate) override {
+            sample_rate_ = sample_rate;
+            active_ = true;
+            return true;
+        }
+        
+        void end() override {
+            active_ = false;
+            clearSource();
+        }
+        
+        bool isActive() const override { return active_; }
+        uint32_t getSampleRate() const override { return sample_rate_; }
+        size_t preferredBlockSize() const override { return BLOCK_FRAMES; }
+        uint32_t latencyFrames() const override { return 0; }
+        
+        /**
+         * @brief Render and discard audio
+         * @param frames Number of frames to render
+         */
+        void pump(size_t frames) {
+            while (active_ && frames > 0) {
+                const size_t n = std::min(frames, BLOCK_FRAMES);
+                pull(block_.data(), n);
+                last_sample_ = block_[n * CHANNELS - 1];
+                frames -= n;
+            }
+        }
+        
+        /**
+         * @brief Last sample rendered (keeps the work observable)
+         */
+        float lastSample() const { return last_sample_; }
+    };
+
+} // namespace KoeKit
+
+#endif // KOEKIT_AUDIO_BACKEND_H
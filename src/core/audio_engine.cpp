@@ -0,0 +1,772 @@
+/**
+ * @file audio_engine.cpp
+ * @brief Audio engine implementation for KoeKit
+ */
+
+#include "../KoeKit.h"
+
+#if defined(ARDUINO_ARCH_RP2040)
+#include "hardware/sync.h"
+#include "hardware/timer.h"
+#include "pico/multicore.h"
+#endif
+
+namespace KoeKit {
+    
+    // Static member initialization
+    AudioEngine* AudioEngine::instance_ = nullptr;
+    
+    // Lengths of idle and silent runs saturate instead of wrapping
+    static uint32_t extendRun(uint32_t run, size_t frames) {
+        return run < UINT32_MAX - frames ? run + static_cast<uint32_t>(frames) : UINT32_MAX;
+    }
+    
+    //=============================================================================
+    // AudioEngine Implementation
+    //=============================================================================
+    
+    AudioEngine& AudioEngine::getInstance() {
+        if (instance_ == nullptr) {
+            static AudioEngine instance;
+            instance_ = &instance;
+        }
+        return *instance_;
+    }
+    
+    bool AudioEngine::begin(uint32_t sample_rate, uint8_t output_pin, OutputMode mode) {
+#if defined(ARDUINO_ARCH_RP2040)
+        if (mode == OutputMode::DMA_PWM) {
+            DMAPWMAudioOutput& dma_output = DMAPWMAudioOutput::getInstance();
+            dma_output.setOutputPin(output_pin);
+            return begin(dma_output, sample_rate);
+        }
+        
+        PWMAudioOutput& pwm_output = PWMAudioOutput::getInstance();
+        pwm_output.setOutputPin(output_pin);
+        return begin(pwm_output, sample_rate);
+#else
+        // No output hardware on a host build; pass a backend instead
+        (void)sample_rate;
+        (void)output_pin;
+        (void)mode;
+        return false;
+#endif
+    }
+    
+    bool AudioEngine::begin(AudioOutput& output, uint32_t sample_rate) {
+        if (initialized_) {
+            end(); // Stop current operation
+        }
+        
+        ring_block_ = nullptr;
+        ring_pos_ = 0;
+        render_ring_.reset();
+        
+        const uint32_t render_rate = internal_rate_ != 0 ? internal_rate_ : sample_rate;
+        resampling_ = render_rate != sample_rate;
+        if (resampling_ &&
+            !resampler_.begin(render_rate, sample_rate, resample_quality_, BLOCK_SIZE)) {
+            return false;
+        }
+        decimator_.begin(oversampling_);
+        requested_oversampling_.store(oversampling_, std::memory_order_relaxed);
+        factor_fade_left_ = 0;
+        params_.clearSchedule();
+        frame_time_.store(0, std::memory_order_relaxed);
+        stats_.begin(render_rate);
+        governor_.begin(static_cast<float>(render_rate) / BLOCK_SIZE);
+        output.resetClipCount();
+        
+        input_block_ = nullptr;
+        input_pos_ = 0;
+        idle_frames_ = 0;
+        silent_frames_.store(0, std::memory_order_relaxed);
+        
+        // Outputs and rings start their counters from zero; the parameter
+        // queue keeps counting across runs
+        reported_ = TelemetryMarks{};
+        reported_.dropped = params_.getDroppedCount();
+        reported_.late = params_.getLateCount();
+        if (input_ && !input_->begin(render_rate)) {
+            return false;
+        }
+        
+        // Set before core1 starts: its telemetry reads the output
+        output_ = &output;
+        output_->setSource(&AudioEngine::renderBlockThunk, this);
+
+#if defined(ARDUINO_ARCH_RP2040)
+        if (render_mode_ == RenderMode::DUAL_CORE) {
+            // One output pull must be satisfiable from the ring
+            const uint64_t input_frames =
+                (static_cast<uint64_t>(output.preferredBlockSize()) * render_rate +
+                 sample_rate - 1) / sample_rate;
+            const size_t ring_blocks =
+                static_cast<size_t>((input_frames + BLOCK_SIZE - 1) / BLOCK_SIZE);
+            if (ring_blocks > KOEKIT_RENDER_BLOCKS) {
+                output_ = nullptr;
+                if (input_) {
+                    input_->end();
+                }
+                return false;
+            }
+            startRenderCore();
+        }
+#endif
+
+        if (!output_->begin(sample_rate)) {
+#if defined(ARDUINO_ARCH_RP2040)
+            stopRenderCore();
+#endif
+            output_ = nullptr;
+            if (input_) {
+                input_->end();
+            }
+            return false;
+        }
+        
+        initialized_ = true;
+        return true;
+    }
+    
+    void AudioEngine::render(float* out, size_t frames) {
+        while (frames > 0) {
+            const size_t chunk = std::min(frames, BLOCK_SIZE);
+            renderBlock(out, chunk);
+            out += chunk * CHANNELS;
+            frames -= chunk;
+        }
+    }
+    
+    void AudioEngine::setCallback(AudioCallback callback) {
+        Patch& patch = patches_[back_];
+        patch = Patch{};
+        patch.callback = callback;
+        publishPatch();
+    }
+    
+    void AudioEngine::setBlockCallback(BlockCallback callback, void* context) {
+        Patch& patch = patches_[back_];
+        patch = Patch{};
+        patch.block_callback = callback;
+        patch.block_context = context;
+        publishPatch();
+    }
+    
+    void AudioEngine::setProcessCallback(ProcessCallback callback, void* context) {
+        Patch& patch = patches_[back_];
+        patch = Patch{};
+        patch.process_callback = callback;
+        patch.block_context = context;
+        publishPatch();
+    }
+    
+    void AudioEngine::setInput(AudioInput* input) {
+        if (!initialized_) {
+            input_ = input;
+        }
+    }
+    
+    void AudioEngine::setIdleCheck(IdleCheck check) {
+        if (!initialized_) {
+            idle_check_ = check;
+        }
+    }
+    
+    void AudioEngine::setCrossfade(float seconds) {
+        crossfade_seconds_.store(seconds > 0.0f ? seconds : 0.0f, std::memory_order_relaxed);
+    }
+    
+    void AudioEngine::publishPatch() {
+        // Whatever comes back is free: an unplayed patch this one replaces,
+        // or a slot the render context has finished with
+        const uint8_t previous = middle_.exchange(back_ | PATCH_DIRTY, std::memory_order_acq_rel);
+        back_ = previous & ~PATCH_DIRTY;
+    }
+    
+    void AudioEngine::end() {
+        stop();
+        patches_.fill(Patch{});
+        back_ = 0;
+        middle_.store(1, std::memory_order_relaxed);
+        front_ = 2;
+        retired_ = 3;
+        fade_left_ = 0;
+    }
+    
+    void AudioEngine::stop() {
+        if (output_) {
+            output_->end();
+        }
+        // core1 reads output_ until it has stopped
+#if defined(ARDUINO_ARCH_RP2040)
+        stopRenderCore();
+#endif
+        output_ = nullptr;
+        if (input_) {
+            input_->end();
+        }
+        initialized_ = false;
+    }
+    
+    bool AudioEngine::isActive() const {
+        return initialized_ && output_ && output_->isActive();
+    }
+    
+    uint32_t AudioEngine::getSampleRate() const {
+        return output_ ? output_->getSampleRate() : 0;
+    }
+    
+    void AudioEngine::setRenderMode(RenderMode mode) {
+        if (!initialized_) {
+            render_mode_ = mode;
+        }
+    }
+    
+    void AudioEngine::setInternalRate(uint32_t rate, ResampleQuality quality) {
+        if (!initialized_) {
+            internal_rate_ = rate;
+            resample_quality_ = quality;
+        }
+    }
+    
+    void AudioEngine::setOversampling(Oversampling factor) {
+        if (!initialized_) {
+            oversampling_ = factor;
+            decimator_.begin(factor);
+        }
+        requested_oversampling_.store(factor, std::memory_order_relaxed);
+    }
+    
+    uint32_t AudioEngine::getRenderRate() const {
+        const uint32_t rate = internal_rate_ != 0 ? internal_rate_ : getSampleRate();
+        return rate * static_cast<uint32_t>(requested_oversampling_.load(std::memory_order_relaxed));
+    }
+    
+    uint32_t AudioEngine::getUnderrunCount() const {
+        const uint32_t output_underruns = output_ ? output_->getUnderrunCount() : 0;
+        return render_ring_.underruns() + output_underruns;
+    }
+    
+    uint32_t AudioEngine::getOverrunCount() const {
+        return render_ring_.overruns();
+    }
+    
+    RenderStats AudioEngine::getStats() const {
+        return stats_.snapshot(output_ ? output_->getClipCount() : 0);
+    }
+    
+    void AudioEngine::resetStats() {
+        stats_.reset();
+        if (output_) {
+            output_->resetClipCount();
+        }
+    }
+    
+    uint32_t AudioEngine::getLatencyFrames() const {
+        if (!output_) {
+            return 0;
+        }
+        // Ring and resampler delays are in render-rate frames
+        uint32_t render_latency = 0;
+        if (render_core_running_.load(std::memory_order_relaxed)) {
+            render_latency += KOEKIT_RENDER_BLOCKS * BLOCK_SIZE;
+        }
+        if (resampling_) {
+            render_latency += static_cast<uint32_t>(resampler_.latencyFrames());
+        }
+        render_latency += static_cast<uint32_t>(decimator_.latencyFrames());
+        const uint32_t render_rate = internal_rate_ != 0 ? internal_rate_ : getSampleRate();
+        const uint64_t scaled = static_cast<uint64_t>(render_latency) * getSampleRate() /
+                                render_rate;
+        return output_->latencyFrames() + static_cast<uint32_t>(scaled);
+    }
+    
+    uint32_t AudioEngine::getRoundTripLatencyFrames() const {
+        if (!output_ || !input_) {
+            return getLatencyFrames();
+        }
+        // The input runs at the render rate
+        const uint32_t render_rate = internal_rate_ != 0 ? internal_rate_ : getSampleRate();
+        const uint64_t input_latency = static_cast<uint64_t>(input_->latencyFrames()) *
+                                       getSampleRate() / render_rate;
+        return getLatencyFrames() + static_cast<uint32_t>(input_latency);
+    }
+    
+    void AudioEngine::readRing(float* out, size_t frames) {
+        size_t samples = frames * CHANNELS;
+        while (samples > 0) {
+            if (ring_block_ == nullptr) {
+                ring_block_ = render_ring_.acquireRead();
+                ring_pos_ = 0;
+                if (ring_block_ == nullptr) {
+                    // Underrun: play silence until core1 catches up
+                    std::fill(out, out + samples, 0.0f);
+                    return;
+                }
+            }
+            
+            const size_t n = std::min(samples, RING_BLOCK_SAMPLES - ring_pos_);
+            std::copy(ring_block_ + ring_pos_, ring_block_ + ring_pos_ + n, out);
+            ring_pos_ += n;
+            out += n;
+            samples -= n;
+            
+            if (ring_pos_ == RING_BLOCK_SAMPLES) {
+                render_ring_.releaseRead();
+                ring_block_ = nullptr;
+#if defined(ARDUINO_ARCH_RP2040)
+                __sev(); // Wake the render core
+#endif
+            }
+        }
+    }
+    
+    void AudioEngine::renderBlock(float* out, size_t frames) {
+        const uint32_t start = Timing::now();
+        
+        params_.process();
+        swapPatch();
+        
+        // A change requested during a factor fade waits for it to finish
+        const Oversampling requested = requested_oversampling_.load(std::memory_order_relaxed);
+        if (requested != oversampling_ && factor_fade_left_ == 0) {
+            beginFactorFade(requested);
+        }
+        
+        // Split the block at each scheduled message so it lands on its frame
+        const size_t factor = decimator_.factor();
+        float* target = factor == 1 ? out : oversample_block_.data();
+        const uint32_t now = frame_time_.load(std::memory_order_relaxed);
+        bool idle = true;
+        size_t done = 0;
+        while (done < frames) {
+            size_t chunk = params_.dispatch(now + static_cast<uint32_t>(done), frames - done);
+            const float* in = input_ ? readInput(chunk, factor) : nullptr;
+            idle = runCallback(in, &target[done * factor * CHANNELS], chunk * factor) && idle;
+            done += chunk;
+        }
+        if (factor != 1) {
+            // Once zeros have flushed the filters they can only output zeros
+            if (idle && idle_frames_ >= decimator_.settleFrames()) {
+                std::fill(out, out + frames * CHANNELS, 0.0f);
+            } else {
+                decimator_.process(oversample_block_.data(), out, frames);
+            }
+        }
+        if (factor_fade_left_ > 0) {
+            fadeFactor(target, factor, out, frames);
+        }
+        idle_frames_ = idle ? extendRun(idle_frames_, frames) : 0;
+        frame_time_.store(now + static_cast<uint32_t>(frames), std::memory_order_relaxed);
+        
+        const uint32_t elapsed = Timing::now() - start;
+        stats_.record(elapsed, frames, idle);
+        governor_.update(elapsed, stats_.budgetTicks(frames));
+        reportTelemetry(out, frames, now, elapsed);
+        
+        const bool silent = Detail::isSilent(out, frames * CHANNELS);
+        silent_frames_.store(silent ? extendRun(silent_frames_.load(std::memory_order_relaxed),
+                                                frames)
+                                    : 0,
+                             std::memory_order_relaxed);
+    }
+    
+    void AudioEngine::reportTelemetry(float* out, size_t frames, uint32_t frame, uint32_t elapsed) {
+        if (telemetry_.enabled(TelemetryEvent::NAN_DETECTED)) {
+            uint32_t bad = 0;
+            for (size_t i = 0; i < frames * CHANNELS; ++i) {
+                if (!std::isfinite(out[i])) {
+                    out[i] = 0.0f;
+                    ++bad;
+                }
+            }
+            if (bad > 0) {
+                telemetry_.log(TelemetryEvent::NAN_DETECTED, frame, 0, bad);
+            }
+        }
+        
+        const uint32_t budget = stats_.budgetTicks(frames);
+        if (budget > 0 && elapsed > budget) {
+            telemetry_.log(TelemetryEvent::DEADLINE_MISS, frame, 0, stats_.ticksToMicros(elapsed));
+        }
+        const uint32_t interval = telemetry_.getTimingInterval();
+        if (interval > 0 && ++reported_.timing_blocks >= interval) {
+            reported_.timing_blocks = 0;
+            telemetry_.log(TelemetryEvent::RENDER_TIME, frame, 0, stats_.ticksToMicros(elapsed));
+        }
+        
+        // Read once: on core1 this runs beside loop()'s begin() and end()
+        AudioOutput* const output = output_;
+        const uint32_t output_underruns = output ? output->getUnderrunCount() : 0;
+        reportCount(TelemetryEvent::UNDERRUN, render_ring_.underruns() + output_underruns,
+                    reported_.underruns, frame);
+        reportCount(TelemetryEvent::OVERRUN, render_ring_.overruns(), reported_.overruns, frame);
+        if (output) {
+            reportCount(TelemetryEvent::CLIP, output->getClipCount(), reported_.clips, frame);
+        }
+        reportCount(TelemetryEvent::PARAM_DROPPED, params_.getDroppedCount(), reported_.dropped,
+                    frame);
+        reportCount(TelemetryEvent::PARAM_LATE, params_.getLateCount(), reported_.late, frame);
+        if (input_) {
+            reportCount(TelemetryEvent::INPUT_UNDERRUN, input_->getUnderrunCount(),
+                        reported_.input_underruns, frame);
+            reportCount(TelemetryEvent::INPUT_SKIP, input_->getSkipCount(),
+                        reported_.input_skips, frame);
+        }
+        const uint8_t level = governor_.getLevel();
+        if (level != reported_.level) {
+            telemetry_.log(TelemetryEvent::LOAD_LEVEL, frame, 0, level);
+            reported_.level = level;
+        }
+    }
+    
+    void AudioEngine::reportCount(TelemetryEvent type, uint32_t count, uint32_t& reported,
+                                  uint32_t frame) {
+        if (count != reported) {
+            // A counter below its mark was reset by a restart
+            telemetry_.log(type, frame, 0, count > reported ? count - reported : count);
+            reported = count;
+        }
+    }
+    
+    bool AudioEngine::runCallback(const float* in, float* out, size_t frames) {
+        Patch& patch = patches_[front_];
+        bool idle = true;
+        while (frames > 0) {
+            const size_t chunk = std::min(frames, BLOCK_SIZE);
+            if (fade_left_ == 0 && idle_check_ && idle_check_()) {
+                std::fill(out, out + chunk * CHANNELS, 0.0f);
+            } else {
+                idle = false;
+                patch.render(in, out, chunk);
+                if (fade_left_ > 0) {
+                    crossfade(in, out, chunk);
+                }
+            }
+            if (in) {
+                in += chunk * CHANNELS;
+            }
+            out += chunk * CHANNELS;
+            frames -= chunk;
+        }
+        return idle;
+    }
+    
+    const float* AudioEngine::readInput(size_t& frames, size_t factor) {
+        if (input_block_ != nullptr && input_pos_ == BLOCK_SIZE) {
+            if (input_block_ != Detail::SILENT_BLOCK.data()) {
+                input_->releaseBlock();
+            }
+            input_block_ = nullptr;
+        }
+        if (input_block_ == nullptr) {
+            input_block_ = input_->acquireBlock();
+            if (input_block_ == nullptr) {
+                input_block_ = Detail::SILENT_BLOCK.data();     // Underrun
+            }
+            input_pos_ = 0;
+        }
+        
+        // Never cross into the next block, so the run stays in place
+        frames = std::min(frames, BLOCK_SIZE - input_pos_);
+        const float* in = input_block_ + input_pos_ * CHANNELS;
+        input_pos_ += frames;
+        if (factor == 1) {
+            return in;
+        }
+        
+        float* held = input_hold_.data();
+        for (size_t i = 0; i < frames; ++i) {
+            for (size_t k = 0; k < factor; ++k) {
+                std::copy(in + i * CHANNELS, in + (i + 1) * CHANNELS, held);
+                held += CHANNELS;
+            }
+        }
+        return input_hold_.data();
+    }
+    
+    void AudioEngine::Patch::render(const float* in, float* out, size_t frames) {
+        if (process_callback) {
+            process_callback(in ? in : Detail::SILENT_BLOCK.data(), out, frames, block_context);
+        } else if (block_callback) {
+            block_callback(out, frames, block_context);
+        } else if (callback) {
+            for (size_t i = 0; i < frames; ++i) {
+                Detail::writeFrame(out, i, callback());
+            }
+        } else {
+            std::fill(out, out + frames * CHANNELS, 0.0f); // Silence
+        }
+    }
+    
+    void AudioEngine::swapPatch() {
+        // The retired slot goes back to loop(), so it must be done fading
+        if (fade_left_ > 0 || !(middle_.load(std::memory_order_relaxed) & PATCH_DIRTY)) {
+            return;
+        }
+        const uint8_t incoming = middle_.exchange(retired_, std::memory_order_acq_rel);
+        retired_ = front_;
+        front_ = incoming & ~PATCH_DIRTY;
+        
+        const float fade_frames = crossfade_seconds_.load(std::memory_order_relaxed) *
+                                  static_cast<float>(getRenderRate());
+        if (fade_frames >= 1.0f) {
+            // A quarter turn in exactly fade_left_ steps: the step after the
+            // last faded frame lands on (0, 1), the gains the fade hands over at
+            fade_left_ = static_cast<uint32_t>(fade_frames);
+            const float step = 0.25f * TWO_PI / static_cast<float>(fade_left_);
+            fade_old_ = 1.0f;
+            fade_new_ = 0.0f;
+            fade_cos_ = std::cos(step);
+            fade_sin_ = std::sin(step);
+        }
+    }
+    
+    void AudioEngine::beginFactorFade(Oversampling factor) {
+        // The old chain keeps its history. The new one starts from zeros,
+        // so it only fades in once real input has filled its filters
+        fade_decimator_ = decimator_;
+        decimator_.begin(factor);
+        oversampling_ = factor;
+        
+        const uint32_t rate = internal_rate_ != 0 ? internal_rate_ : getSampleRate();
+        const float fade_frames = crossfade_seconds_.load(std::memory_order_relaxed) *
+                                  static_cast<float>(rate);
+        const uint32_t ramp = std::max(static_cast<uint32_t>(fade_frames),
+                                       static_cast<uint32_t>(BLOCK_SIZE));
+        factor_fade_hold_ = static_cast<uint32_t>(decimator_.settleFrames());
+        factor_fade_left_ = factor_fade_hold_ + ramp;
+        // Both chains carry the same signal, so the gains sum to one; the
+        // step after the last faded frame lands on 1
+        factor_fade_step_ = 1.0f / static_cast<float>(ramp + 1);
+        factor_fade_gain_ = 0.0f;
+    }
+    
+    void AudioEngine::fadeFactor(const float* rendered, size_t factor, float* out, size_t frames) {
+        // Feed the old chain at its own rate: repeat frames when it ran
+        // faster, average them when it ran slower
+        const size_t old_factor = fade_decimator_.factor();
+        float* in = fade_input_.data();
+        if (old_factor > factor) {
+            const size_t repeat = old_factor / factor;
+            for (size_t i = 0; i < frames * factor; ++i) {
+                for (size_t r = 0; r < repeat; ++r) {
+                    for (size_t c = 0; c < CHANNELS; ++c) {
+                        *in++ = rendered[i * CHANNELS + c];
+                    }
+                }
+            }
+        } else {
+            const size_t group = factor / old_factor;
+            const float scale = 1.0f / static_cast<float>(group);
+            for (size_t i = 0; i < frames * old_factor; ++i) {
+                for (size_t c = 0; c < CHANNELS; ++c) {
+                    float sum = 0.0f;
+                    for (size_t g = 0; g < group; ++g) {
+                        sum += rendered[(i * group + g) * CHANNELS + c];
+                    }
+                    *in++ = sum * scale;
+                }
+            }
+        }
+        // fade_block_ is free once the callback has run
+        fade_decimator_.process(fade_input_.data(), fade_block_.data(), frames);
+        
+        const size_t n = std::min(frames, static_cast<size_t>(factor_fade_left_));
+        for (size_t i = 0; i < n; ++i) {
+            if (factor_fade_hold_ > 0) {
+                --factor_fade_hold_;
+            } else {
+                factor_fade_gain_ += factor_fade_step_;
+            }
+            const float old_gain = 1.0f - factor_fade_gain_;
+            for (size_t c = 0; c < CHANNELS; ++c) {
+                const size_t s = i * CHANNELS + c;
+                out[s] = out[s] * factor_fade_gain_ + fade_block_[s] * old_gain;
+            }
+        }
+        factor_fade_left_ -= static_cast<uint32_t>(n);
+    }
+    
+    void AudioEngine::crossfade(const float* in, float* out, size_t frames) {
+        // The old patch keeps running for the whole chunk so its state
+        // stays continuous up to the last faded frame
+        patches_[retired_].render(in, fade_block_.data(), frames);
+        const size_t n = std::min(frames, static_cast<size_t>(fade_left_));
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t c = 0; c < CHANNELS; ++c) {
+                const size_t s = i * CHANNELS + c;
+                out[s] = out[s] * fade_new_ + fade_block_[s] * fade_old_;
+            }
+            const float old_gain = fade_old_ * fade_cos_ - fade_new_ * fade_sin_;
+            fade_new_ = fade_new_ * fade_cos_ + fade_old_ * fade_sin_;
+            fade_old_ = old_gain;
+        }
+        fade_left_ -= static_cast<uint32_t>(n);
+    }
+    
+    void AudioEngine::renderBlockThunk(float* out, size_t frames, void* context) {
+        AudioEngine* engine = static_cast<AudioEngine*>(context);
+        if (engine->resampling_) {
+            engine->resampler_.process(out, frames, &AudioEngine::renderSource, engine);
+        } else {
+            renderSource(out, frames, engine);
+        }
+    }
+    
+    void AudioEngine::renderSource(float* out, size_t frames, void* context) {
+        AudioEngine* engine = static_cast<AudioEngine*>(context);
+        if (engine->render_core_running_.load(std::memory_order_relaxed)) {
+            engine->readRing(out, frames);
+        } else {
+            engine->render(out, frames);
+        }
+    }
+
+#if defined(ARDUINO_ARCH_RP2040)
+    void AudioEngine::startRenderCore() {
+        render_core_stop_.store(false, std::memory_order_relaxed);
+        render_core_running_.store(true, std::memory_order_release);
+        multicore_launch_core1(&AudioEngine::renderCoreEntry);
+        
+        // Let core1 fill the ring before the output starts draining it
+        const uint64_t deadline = time_us_64() + 100000;
+        while (render_ring_.writable() > 0 && time_us_64() < deadline) {
+            tight_loop_contents();
+        }
+    }
+    
+    void AudioEngine::stopRenderCore() {
+        if (!render_core_running_.load(std::memory_order_acquire)) {
+            return;
+        }
+        render_core_stop_.store(true, std::memory_order_release);
+        __sev();
+        while (render_core_running_.load(std::memory_order_acquire)) {
+            tight_loop_contents();
+        }
+        multicore_reset_core1();
+    }
+    
+    void AudioEngine::renderCoreEntry() {
+        AudioEngine& engine = getInstance();
+        auto& ring = engine.render_ring_;
+        
+        while (!engine.render_core_stop_.load(std::memory_order_acquire)) {
+            // Sleep until the output frees a block
+            if (ring.writable() == 0) {
+                __wfe();
+                continue;
+            }
+            float* block = ring.acquireWrite();
+            engine.renderBlock(block, BLOCK_SIZE);
+            ring.commitWrite();
+        }
+        
+        engine.render_core_running_.store(false, std::memory_order_release);
+    }
+#endif // ARDUINO_ARCH_RP2040
+
+    //=============================================================================
+    // Global Functions
+    //=============================================================================
+    
+    bool begin(uint32_t sample_rate, uint8_t output_pin, OutputMode mode) {
+        return AudioEngine::getInstance().begin(sample_rate, output_pin, mode);
+    }
+    
+    bool begin(AudioOutput& output, uint32_t sample_rate) {
+        return AudioEngine::getInstance().begin(output, sample_rate);
+    }
+    
+    void setAudioCallback(AudioCallback callback) {
+        AudioEngine::getInstance().setCallback(callback);
+    }
+    
+    void setBlockCallback(BlockCallback callback, void* context) {
+        AudioEngine::getInstance().setBlockCallback(callback, context);
+    }
+    
+    void setProcessCallback(ProcessCallback callback, void* context) {
+        AudioEngine::getInstance().setProcessCallback(callback, context);
+    }
+    
+    void setInput(AudioInput* input) {
+        AudioEngine::getInstance().setInput(input);
+    }
+    
+    void setCrossfade(float seconds) {
+        AudioEngine::getInstance().setCrossfade(seconds);
+    }
+    
+    void setIdleCheck(IdleCheck check) {
+        AudioEngine::getInstance().setIdleCheck(check);
+    }
+    
+    uint32_t getSilentFrames() {
+        return AudioEngine::getInstance().getSilentFrames();
+    }
+    
+    bool logEvent(TelemetryEvent type, uint8_t arg, uint32_t value) {
+        AudioEngine& engine = AudioEngine::getInstance();
+        return engine.getTelemetry().log(type, engine.getFrameTime(), arg, value);
+    }
+    
+    size_t drainTelemetry(TelemetryRecord* out, size_t max_records) {
+        return AudioEngine::getInstance().getTelemetry().drain(out, max_records);
+    }
+    
+    void setRenderMode(RenderMode mode) {
+        AudioEngine::getInstance().setRenderMode(mode);
+    }
+    
+    void setInternalRate(uint32_t rate, ResampleQuality quality) {
+        AudioEngine::getInstance().setInternalRate(rate, quality);
+    }
+    
+    void setOversampling(Oversampling factor) {
+        AudioEngine::getInstance().setOversampling(factor);
+    }
+    
+    ParamId addParameter(ParamHandler handler) {
+        return AudioEngine::getInstance().getParams().addParameter(handler);
+    }
+    
+    ParamId addEvent(ParamHandler handler) {
+        return AudioEngine::getInstance().getParams().addEvent(handler);
+    }
+    
+    bool setParameter(ParamId id, float value) {
+        return AudioEngine::getInstance().getParams().set(id, value);
+    }
+    
+    bool sendEvent(ParamId id, float value) {
+        return AudioEngine::getInstance().getParams().send(id, value);
+    }
+    
+    bool setParameterAt(ParamId id, float value, uint32_t frame) {
+        return AudioEngine::getInstance().getParams().schedule(id, value, frame);
+    }
+    
+    bool sendEventAt(ParamId id, float value, uint32_t frame) {
+        return AudioEngine::getInstance().getParams().schedule(id, value, frame);
+    }
+    
+    bool addLoadPolicy(LoadPolicyHandler handler, uint8_t levels) {
+        return AudioEngine::getInstance().getGovernor().addPolicy(handler, levels);
+    }
+    
+    uint32_t getFrameTime() {
+        return AudioEngine::getInstance().getFrameTime();
+    }
+    
+    void end() {
+        AudioEngine::getInstance().end();
+    }
+    
+    uint32_t getSampleRate() {
+        return AudioEngine::getInstance().getSampleRate();
+    }
+
+} // namespace KoeKit
\ No newline at end of file
@@ -0,0 +1,262 @@
+#pragma once
+
+/**
+ * @file audio_input.h
+ * @brief Block-oriented audio input backends for KoeKit
+ */
+
+#ifndef KOEKIT_AUDIO_INPUT_H
+#define KOEKIT_AUDIO_INPUT_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "block_ring.h"
+
+#ifndef KOEKIT_INPUT_BLOCKS
+#define KOEKIT_INPUT_BLOCKS 4
+#endif
+
+namespace KoeKit {
+    
+    namespace Detail {
+        /**
+         * @brief Input handed to process callbacks when nothing was captured
+         */
+        inline constexpr std::array<float, BLOCK_SIZE * CHANNELS> SILENT_BLOCK = {};
+    }
+    
+    /**
+     * @brief Audio input backend
+     *
+     * An input captures BLOCK_SIZE frames of CHANNELS interleaved samples
+     * (-1.0 to 1.0) at a time straight into the blocks of a ring, and the
+     * engine hands each captured block to the process callback in place.
+     * Capture runs on its own clock. The engine waits for PRIME_BLOCKS
+     * blocks before it takes the first one, which keeps a block of slack
+     * between capture and render: either clock can drift by a whole block
+     * before it drops a stale block (input ahead) or plays silence (input
+     * behind). After an underrun it waits for the slack again.
+     */
+    class AudioInput {
+    public:
+        static constexpr size_t BLOCK_SAMPLES = BLOCK_SIZE * CHANNELS;
+        static constexpr size_t NUM_BLOCKS = KOEKIT_INPUT_BLOCKS;
+        static constexpr size_t PRIME_BLOCKS = 2;   // The block to play and one of slack
+        
+        static_assert(NUM_BLOCKS > PRIME_BLOCKS, "Input ring needs room beyond the slack");
+        
+        virtual ~AudioInput() = default;
+        
+        /**
+         * @brief Start capturing
+         * @param sample_rate Sample rate in Hz (the engine's render rate)
+         * @return true if initialization successful
+         */
+        virtual bool begin(uint32_t sample_rate) = 0;
+        
+        /**
+         * @brief Stop capturing
+         */
+        virtual void end() = 0;
+        
+        /**
+         * @brief Check if capture is running
+         */
+        virtual bool isActive() const = 0;
+        
+        /**
+         * @brief Get current sample rate
+         * @return Sample rate in Hz
+         */
+        virtual uint32_t getSampleRate() const = 0;
+        
+        /**
+         * @brief Frames between a sample arriving and it reaching the callback
+         *
+         * Includes the block of slack; at the render rate.
+         */
+        virtual uint32_t latencyFrames() const { return PRIME_BLOCKS * BLOCK_SIZE; }
+        
+        //---------------------------------------------------------------------
+        // Consumer side (render context)
+        //---------------------------------------------------------------------
+        
+        /**
+         * @brief Get the next captured block
+         *
+         * Returns nothing until PRIME_BLOCKS blocks are waiting, then skips
+         * blocks that would put the render more than PRIME_BLOCKS blocks
+         * behind the capture. Call releaseBlock() once it has been used.
+         *
+         * @return BLOCK_SAMPLES samples, or nullptr if none is ready
+         */
+        const float* acquireBlock() {
+            const size_t wanted = primed_ ? 1 : PRIME_BLOCKS;
+            while (ring_.readable() < wanted) {
+                const size_t before = ring_.readable();
+                poll();
+                if (ring_.readable() == before) {
+                    break;
+                }
+            }
+            if (!primed_) {
+                // Priming is not an underrun
+                if (ring_.readable() < PRIME_BLOCKS) {
+                    return nullptr;
+                }
+                primed_ = true;
+            }
+            while (ring_.readable() > PRIME_BLOCKS) {
+                ring_.releaseRead();
+                skipped_.store(skipped_.load(std::memory_order_relaxed) + 1,
+                               std::memory_order_relaxed);
+            }
+            const float* block = ring_.acquireRead();
+            if (block == nullptr) {
+                primed_ = false;    // Underrun: build the slack up again
+            }
+            return block;
+        }
+        
+        /**
+         * @brief Return the block from acquireBlock() to the capture side
+         */
+        void releaseBlock() {
+            ring_.releaseRead();
+        }
+        
+        /**
+         * @brief Blocks lost because the ring was full when they were captured
+         */
+        uint32_t getOverrunCount() const { return ring_.overruns(); }
+        
+        /**
+         * @brief Times the render found no captured block and used silence
+         */
+        uint32_t getUnderrunCount() const { return ring_.underruns(); }
+        
+        /**
+         * @brief Captured blocks dropped to keep the input latency bounded
+         */
+        uint32_t getSkipCount() const { return skipped_.load(std::memory_order_relaxed); }
+        
+    protected:
+        //---------------------------------------------------------------------
+        // Capture side (DMA interrupt, or poll())
+        //---------------------------------------------------------------------
+        
+        /**
+         * @brief Capture on demand (host inputs without a clock of their own)
+         *
+         * Called by acquireBlock() when no block is waiting.
+         */
+        virtual void poll() {}
+        
+        /**
+         * @brief Get the next free block to capture into
+         * @return BLOCK_SAMPLES samples, or nullptr if the ring is full
+         */
+        float* acquireCapture() noexcept { return ring_.acquireWrite(); }
+        
+        /**
+         * @brief Publish the block returned by acquireCapture()
+         */
+        void commitCapture() noexcept { ring_.commitWrite(); }
+        
+        /**
+         * @brief Drop all blocks and clear the counters (while stopped)
+         */
+        void resetCapture() noexcept {
+            ring_.reset();
+            primed_ = false;
+            skipped_.store(0, std::memory_order_relaxed);
+        }
+        
+    private:
+        BlockRing<float, BLOCK_SAMPLES, NUM_BLOCKS> ring_;
+        std::atomic<uint32_t> skipped_{0};     // Written by the consumer only
+        bool primed_ = false;                   // Consumer only
+    };
+    
+    /**
+     * @brief RP2350 ADC input captured by DMA
+     *
+     * The ADC free-runs at CHANNELS times the sample rate, stepping through
+     * the configured inputs round-robin, and two chained DMA channels
+     * alternately fill two halves of a capture buffer from its FIFO. The
+     * completion interrupt converts the finished half into the next ring
+     * block, once, and re-arms it; no samples are copied after that.
+     *
+     * The ADC clock (48 MHz USB PLL) divides down to the sample rate with an
+     * 8-bit fraction, so capture and output drift apart by a few ppm at
+     * most; the engine absorbs that by skipping or repeating a block.
+     */
+    class ADCAudioInput : public AudioInput {
+    private:
+        static constexpr uint8_t FIRST_PIN = 26;        // GPIO of ADC input 0
+        static ADCAudioInput* instance_;
+        
+        std::array<uint8_t, CHANNELS> inputs_ = {};     // ADC input per channel
+        std::array<std::array<uint16_t, BLOCK_SAMPLES>, 2> capture_ = {};
+        int dma_channels_[2] = {-1, -1};
+        uint32_t sample_rate_ = SAMPLE_RATE;
+        volatile bool active_ = false;
+        
+    public:
+        ADCAudioInput() {
+            for (size_t c = 0; c < CHANNELS; ++c) {
+                inputs_[c] = static_cast<uint8_t>(c);
+            }
+        }
+        
+        /**
+         * @brief Set the input pin of a channel (call before begin())
+         *
+         * GPIO 26-29 are ADC inputs 0-3; channel c defaults to GPIO 26 + c.
+         * The round-robin sequencer visits inputs in ascending order, so
+         * channels must use ascending pins.
+         *
+         * @param pin ADC-capable GPIO (26-29)
+         * @param channel Channel index (0 = left)
+         */
+        void setInputPin(uint8_t pin, size_t channel = 0) noexcept {
+            if (channel < CHANNELS && pin >= FIRST_PIN) {
+                inputs_[channel] = static_cast<uint8_t>(pin - FIRST_PIN);
+            }
+        }
+        
+        /**
+         * @brief Get the input pin of a channel
+         * @param channel Channel index
+         * @return GPIO number
+         */
+        uint8_t getInputPin(size_t channel = 0) const {
+            return static_cast<uint8_t>(FIRST_PIN + inputs_[channel < CHANNELS ? channel : 0]);
+        }
+        
+        bool begin(uint32_t sample_rate) override;
+        void end() override;
+        bool isActive() const override { return active_; }
+        uint32_t getSampleRate() const override { return sample_rate_; }
+        
+        /**
+         * @brief A block is handed over once it has been captured completely
+         */
+        uint32_t latencyFrames() const override { return (PRIME_BLOCKS + 1) * BLOCK_SIZE; }
+        
+        /**
+         * @brief Get singleton instance
+         * @return Reference to the singleton instance
+         */
+        static ADCAudioInput& getInstance();
+        
+    private:
+        static void dmaISR();
+        void handleDMAInterrupt();
+    };
+
+} // namespace KoeKit
+
+#endif // KOEKIT_AUDIO_INPUT_H
@@ -3,7 +3,10 @@
  * @brief Audio output implementation for KoeKit
  */
 
-#include "audio_output.h"
+#include "../KoeKit.h"
+
+#if defined(ARDUINO_ARCH_RP2040)
+
 #include "hardware/timer.h"
 #include "hardware/irq.h"
 
@@ -11,10 +14,12 @@ namespace KoeKit {
     
     // Static member initialization
     PWMAudioOutput* PWMAudioOutput::instance_ = nullptr;
-    AudioEngine* AudioEngine::instance_ = nullptr;
     
-    // Timer alarm number (use alarm 0)
-    static constexpr uint AUDIO_ALARM_NUM = 0;
+    // Missed deadlines played back-to-back before the clock is resynchronized
+    static constexpr uint32_t MAX_CATCH_UP_TICKS = 8;
+    
+    // The jitter sum and its tick count are halved once either reaches this
+    static constexpr uint32_t JITTER_DECAY_THRESHOLD = 1u << 30;
     
     //=============================================================================
     // PWMAudioOutput Implementation
@@ -28,181 +33,287 @@ namespace KoeKit {
         return *instance_;
     }
     
-    bool PWMAudioOutput::begin(uint8_t pin, uint32_t sample_rate) {
+    bool PWMAudioOutput::begin(uint32_t sample_rate) {
         if (timer_active_) {
             end(); // Stop current operation
         }
         
-        output_pin_ = pin;
         sample_rate_ = sample_rate;
         
-        // Calculate timer period
-        timer_period_us_ = 1000000 / sample_rate;
+        // Calculate timer period in 32.32 fixed point (no truncation drift)
+        const uint64_t period = (static_cast<uint64_t>(1000000) << 32) / sample_rate;
+        period_us_ = static_cast<uint32_t>(period >> 32);
+        period_frac_ = static_cast<uint32_t>(period);
+        pending_levels_.fill(PWM_CENTER);
+        written_levels_.fill(PWM_CENTER);
+        underruns_ = 0;
+        starved_ = false;
+        for (auto& converter : converters_) {
+            converter.reset();
+        }
+        
+        // Both blocks are rendered before the first tick
+        renderLevels(0);
+        renderLevels(1);
+        ready_[0].store(true, std::memory_order_relaxed);
+        ready_[1].store(true, std::memory_order_relaxed);
+        playing_ = 0;
+        block_pos_ = 0;
         
-        // Setup PWM pin
-        pinMode(output_pin_, OUTPUT);
+        // Setup PWM pins
         analogWriteResolution(PWM_RESOLUTION);
         analogWriteFreq(100000); // 100kHz PWM frequency
+        for (const uint8_t pin : output_pins_) {
+            pinMode(pin, OUTPUT);
+            analogWrite(pin, PWM_CENTER); // Write center value (silence)
+        }
         
-        // Write center value (silence)
-        analogWrite(output_pin_, PWM_CENTER);
-        
-        // Setup timer
+        // Setup render interrupt, then timer
+        if (!setupRender()) {
+            return false;
+        }
+        timer_active_ = true;
         if (!setupTimer()) {
+            stopTimer();
+            stopRender();
+            timer_active_ = false;
             return false;
         }
         
-        timer_active_ = true;
         return true;
     }
     
-    void PWMAudioOutput::setCallback(AudioCallback callback) {
-        callback_ = callback;
-    }
-    
     void PWMAudioOutput::end() {
         if (timer_active_) {
             stopTimer();
             timer_active_ = false;
         }
+        stopRender();
         
-        // Set output to center (silence)
-        if (output_pin_ != 255) {
-            analogWrite(output_pin_, PWM_CENTER);
+        // Set outputs to center (silence)
+        for (const uint8_t pin : output_pins_) {
+            if (pin != 255) {
+                analogWrite(pin, PWM_CENTER);
+            }
         }
         
-        callback_ = nullptr;
+        clearSource();
     }
     
     void PWMAudioOutput::writeSample(float sample) {
         const uint16_t pwm_value = sampleToPWM(sample);
-        analogWrite(output_pin_, pwm_value);
+        for (const uint8_t pin : output_pins_) {
+            analogWrite(pin, pwm_value);
+        }
     }
     
     uint16_t PWMAudioOutput::sampleToPWM(float sample) {
-        // Clamp sample to valid range
-        sample = std::clamp(sample, -1.0f, 1.0f);
-        
-        // Convert to PWM range
-        const float scaled = (sample + 1.0f) * 0.5f; // 0.0 to 1.0
-        const uint16_t pwm_value = static_cast<uint16_t>(scaled * PWM_MAX_VALUE);
-        
-        return std::clamp(pwm_value, static_cast<uint16_t>(0), PWM_MAX_VALUE);
+        if (sample > 1.0f || sample < -1.0f) {
+            countClip();
+        }
+        return PWM::fromSample(sample);
     }
     
-    bool PWMAudioOutput::setupTimer() {
-        // Cancel any existing alarm
-        cancel_alarm(AUDIO_ALARM_NUM);
-        
-        // Set up the alarm
-        const uint64_t period_us = timer_period_us_;
-        const uint64_t target_time = time_us_64() + period_us;
+    ClockStats PWMAudioOutput::getClockStats() const {
+        ClockStats stats;
+        stats.ticks = ticks_;
+        stats.late_ticks = late_ticks_;
+        stats.resyncs = resyncs_;
+        stats.max_jitter_us = max_jitter_us_;
         
-        // Set alarm with callback
-        return alarm_in_us(period_us, timerISR);
-    }
-    
-    void PWMAudioOutput::stopTimer() {
-        cancel_alarm(AUDIO_ALARM_NUM);
+        const uint64_t elapsed_us = time_us_64() - stats_start_us_;
+        if (stats.ticks > 0 && elapsed_us > 0) {
+            stats.effective_rate = static_cast<float>(stats.ticks * 1e6 / elapsed_us);
+        }
+        // Read the pair together: the tick may halve both in between
+        noInterrupts();
+        const uint32_t jitter_sum = jitter_sum_us_;
+        const uint32_t window = jitter_window_;
+        interrupts();
+        if (window > 0) {
+            stats.mean_jitter_us = static_cast<float>(jitter_sum) / window;
+        }
+        return stats;
     }
     
-    void PWMAudioOutput::timerISR() {
-        if (instance_ != nullptr) {
-            instance_->handleTimerInterrupt();
-        }
+    void PWMAudioOutput::resetClockStats() {
+        noInterrupts();
+        stats_start_us_ = time_us_64();
+        ticks_ = 0;
+        late_ticks_ = 0;
+        resyncs_ = 0;
+        max_jitter_us_ = 0;
+        jitter_sum_us_ = 0;
+        jitter_window_ = 0;
+        interrupts();
     }
     
-    void PWMAudioOutput::handleTimerInterrupt() {
-        // Generate next sample
-        float sample = 0.0f;
-        if (callback_) {
-            sample = callback_();
+    bool PWMAudioOutput::setupTimer() {
+        // Claim a free alarm (the core or the sketch may hold some) and
+        // point it at our handler
+        alarm_num_ = hardware_alarm_claim_unused(false);
+        if (alarm_num_ < 0) {
+            return false;
         }
+        hardware_alarm_set_callback(static_cast<uint>(alarm_num_), timerISR);
         
-        // Output sample
-        writeSample(sample);
+        // First deadline one period from now; later ones are absolute
+        resetClockStats();
+        deadline_us_ = stats_start_us_ + period_us_;
+        deadline_frac_ = 0;
         
-        // Schedule next interrupt
-        if (timer_active_) {
-            alarm_in_us(timer_period_us_, timerISR);
-        }
+        return !hardware_alarm_set_target(static_cast<uint>(alarm_num_),
+                                          from_us_since_boot(deadline_us_));
     }
     
-    //=============================================================================
-    // AudioEngine Implementation
-    //=============================================================================
-    
-    AudioEngine& AudioEngine::getInstance() {
-        if (instance_ == nullptr) {
-            static AudioEngine instance;
-            instance_ = &instance;
+    void PWMAudioOutput::stopTimer() {
+        if (alarm_num_ < 0) {
+            return;
         }
-        return *instance_;
+        const uint alarm = static_cast<uint>(alarm_num_);
+        hardware_alarm_cancel(alarm);
+        hardware_alarm_set_callback(alarm, nullptr);
+        hardware_alarm_unclaim(alarm);
+        alarm_num_ = -1;
     }
     
-    bool AudioEngine::begin(uint32_t sample_rate, uint8_t output_pin) {
-        if (initialized_) {
-            end(); // Stop current operation
-        }
-        
-        output_ = &PWMAudioOutput::getInstance();
-        
-        if (!output_->begin(output_pin, sample_rate)) {
+    bool PWMAudioOutput::setupRender() {
+        render_irq_ = user_irq_claim_unused(false);
+        if (render_irq_ < 0) {
             return false;
         }
-        
-        // Set our callback wrapper
-        output_->setCallback([this]() { return audioCallback(); });
-        
-        initialized_ = true;
+        const uint irq = static_cast<uint>(render_irq_);
+        irq_set_exclusive_handler(irq, renderISR);
+        irq_set_priority(irq, PICO_LOWEST_IRQ_PRIORITY);
+        irq_set_enabled(irq, true);
         return true;
     }
     
-    void AudioEngine::setCallback(AudioCallback callback) {
-        user_callback_ = callback;
-    }
-    
-    void AudioEngine::end() {
-        if (output_) {
-            output_->end();
+    void PWMAudioOutput::stopRender() {
+        if (render_irq_ < 0) {
+            return;
         }
-        user_callback_ = nullptr;
-        initialized_ = false;
+        const uint irq = static_cast<uint>(render_irq_);
+        irq_set_enabled(irq, false);
+        irq_remove_handler(irq, renderISR);
+        user_irq_unclaim(irq);
+        render_irq_ = -1;
     }
     
-    bool AudioEngine::isActive() const {
-        return initialized_ && output_ && output_->isActive();
-    }
-    
-    uint32_t AudioEngine::getSampleRate() const {
-        return output_ ? output_->getSampleRate() : 0;
+    void PWMAudioOutput::renderISR() {
+        if (instance_ == nullptr) {
+            return;
+        }
+        // The tick only moves on to a ready block, so the other one stays
+        // ours until it is marked ready
+        PWMAudioOutput& output = *instance_;
+        const uint8_t index = output.playing_ ^ 1;
+        if (!output.ready_[index].load(std::memory_order_relaxed)) {
+            output.renderLevels(index);
+            output.ready_[index].store(true, std::memory_order_release);
+        }
     }
     
-    float AudioEngine::audioCallback() {
-        if (user_callback_) {
-            return user_callback_();
+    void PWMAudioOutput::renderLevels(uint8_t index) {
+        uint16_t* levels = levels_[index].data();
+        pull(block_.data(), BLOCK_SIZE);
+        const bool silent = Detail::isSilent(block_.data(), block_.size());
+        for (size_t c = 0; c < CHANNELS; ++c) {
+            if (silent && converters_[c].fillSilence(levels + c, BLOCK_SIZE, CHANNELS)) {
+                continue;
+            }
+            countClip(converters_[c].convert(block_.data() + c, levels + c, BLOCK_SIZE,
+                                             CHANNELS));
         }
-        return 0.0f; // Silence
     }
     
-    //=============================================================================
-    // Global Functions
-    //=============================================================================
-    
-    bool begin(uint32_t sample_rate, uint8_t output_pin) {
-        return AudioEngine::getInstance().begin(sample_rate, output_pin);
+    void PWMAudioOutput::timerISR(unsigned int alarm_num) {
+        (void)alarm_num;
+        if (instance_ != nullptr) {
+            instance_->handleTimerInterrupt();
+        }
     }
     
-    void setAudioCallback(AudioCallback callback) {
-        AudioEngine::getInstance().setCallback(callback);
+    void PWMAudioOutput::handleTimerInterrupt() {
+        uint32_t catch_up = 0;
+        
+        do {
+            tick(time_us_64());
+            advanceDeadline();
+            
+            // Too far behind to catch up: restart the timebase from now. The
+            // periods in between are dropped, so count it; rendering runs
+            // outside the tick, so only interrupt latency can get here
+            if (++catch_up > MAX_CATCH_UP_TICKS) {
+                deadline_us_ = time_us_64() + period_us_;
+                deadline_frac_ = 0;
+                resyncs_ = resyncs_ + 1;
+                catch_up = 0;
+            }
+            
+            // set_target reports a deadline already in the past; play it now
+        } while (timer_active_ &&
+                 hardware_alarm_set_target(static_cast<uint>(alarm_num_),
+                                           from_us_since_boot(deadline_us_)));
     }
     
-    void end() {
-        AudioEngine::getInstance().end();
+    void PWMAudioOutput::tick(uint64_t now_us) {
+        // Output first, so the edge lands at the same point of every tick.
+        // A held level (silence) needs no write at all.
+        for (size_t c = 0; c < CHANNELS; ++c) {
+            if (pending_levels_[c] != written_levels_[c]) {
+                analogWrite(output_pins_[c], pending_levels_[c]);
+                written_levels_[c] = pending_levels_[c];
+            }
+        }
+        
+        // Lateness relative to this tick's deadline
+        const uint32_t jitter_us = now_us > deadline_us_
+            ? static_cast<uint32_t>(now_us - deadline_us_) : 0;
+        if (jitter_us > max_jitter_us_) {
+            max_jitter_us_ = jitter_us;
+        }
+        if (jitter_us >= period_us_) {
+            late_ticks_ = late_ticks_ + 1;
+        }
+        uint32_t jitter_sum = jitter_sum_us_ + jitter_us;
+        uint32_t jitter_window = jitter_window_ + 1;
+        if (jitter_sum >= JITTER_DECAY_THRESHOLD || jitter_window >= JITTER_DECAY_THRESHOLD) {
+            jitter_sum >>= 1;
+            jitter_window = (jitter_window + 1) >> 1;
+        }
+        jitter_sum_us_ = jitter_sum;
+        jitter_window_ = jitter_window;
+        ticks_ = ticks_ + 1;
+        
+        // At the end of a block move on to the other one and have the
+        // render interrupt refill this one; if it is not ready, hold the
+        // last level until it is
+        if (block_pos_ == BLOCK_SIZE) {
+            const uint8_t next = playing_ ^ 1;
+            if (!ready_[next].load(std::memory_order_acquire)) {
+                if (!starved_) {
+                    starved_ = true;
+                    underruns_ = underruns_ + 1;
+                }
+                return;
+            }
+            starved_ = false;
+            ready_[playing_].store(false, std::memory_order_relaxed);
+            playing_ = next;
+            block_pos_ = 0;
+            irq_set_pending(static_cast<uint>(render_irq_));
+        }
+        const uint16_t* frame = &levels_[playing_][block_pos_++ * CHANNELS];
+        std::copy(frame, frame + CHANNELS, pending_levels_.begin());
     }
     
-    uint32_t getSampleRate() {
-        return AudioEngine::getInstance().getSampleRate();
+    void PWMAudioOutput::advanceDeadline() {
+        const uint32_t previous_frac = deadline_frac_;
+        deadline_frac_ += period_frac_;
+        deadline_us_ += period_us_ + (deadline_frac_ < previous_frac ? 1 : 0);
     }
-    
-} // namespace KoeKit
\ No newline at end of file
+
+} // namespace KoeKit
+
+#endif // ARDUINO_ARCH_RP2040
@@ -8,8 +8,34 @@
 #ifndef KOEKIT_AUDIO_OUTPUT_H
 #define KOEKIT_AUDIO_OUTPUT_H
 
+#if defined(ARDUINO)
 #include <Arduino.h>
-#include <functional>
+#endif
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include "audio_backend.h"
+#include "audio_input.h"
+#include "block_ring.h"
+#include "decimator.h"
+#include "render_stats.h"
+#include "resampler.h"
+#include "telemetry.h"
+#include "dma_pwm_output.h"
+#include "inplace_function.h"
+#include "load_governor.h"
+#include "param_queue.h"
+#include "pwm_convert.h"
+
+#ifndef KOEKIT_RENDER_BLOCKS
+#define KOEKIT_RENDER_BLOCKS 4
+#endif
+
+#ifndef KOEKIT_CALLBACK_CAPACITY
+#define KOEKIT_CALLBACK_CAPACITY 16
+#endif
 
 namespace KoeKit {
     
@@ -17,74 +43,242 @@ namespace KoeKit {
      * @brief Audio output callback function type
      * 
      * Called at sample rate to generate audio samples.
-     * Should return a float value between -1.0 and 1.0.
+     * Should return a float value between -1.0 and 1.0. With CHANNELS > 1
+     * the sample is played on every channel.
+     * Stored in place (KOEKIT_CALLBACK_CAPACITY bytes), so assigning one
+     * never allocates.
+     */
+    using AudioCallback = InplaceFunction<float(), KOEKIT_CALLBACK_CAPACITY>;
+    
+    /**
+     * @brief Block render callback function type
+     * 
+     * Called once per block to fill `out` with `frames` frames of CHANNELS
+     * interleaved samples (-1.0 to 1.0), i.e. frames * CHANNELS floats.
+     * `context` is the pointer given to setBlockCallback().
+     */
+    using BlockCallback = void (*)(float* out, size_t frames, void* context);
+    
+    /**
+     * @brief Effects callback function type
+     * 
+     * Like BlockCallback, with `frames` frames of CHANNELS interleaved input
+     * samples in `in`: the captured input set with setInput(), or silence.
+     * `in` points into the capture buffer; do not write to it.
      */
-    using AudioCallback = std::function<float()>;
+    using ProcessCallback = void (*)(const float* in, float* out, size_t frames, void* context);
+    
+    /**
+     * @brief Idle check function type
+     * 
+     * Called on the audio thread before each chunk is rendered. Returns
+     * true when every voice is idle and the callback would produce exact
+     * silence, e.g. `[]{ return !env.isActive(); }`.
+     */
+    using IdleCheck = InplaceFunction<bool(), KOEKIT_CALLBACK_CAPACITY>;
+    
+    namespace Detail {
+        /**
+         * @brief Store a mono sample in every channel of frame i
+         */
+        inline void writeFrame(float* out, size_t i, float sample) {
+            if constexpr (CHANNELS == 1) {
+                out[i] = sample;
+            } else {
+                for (size_t c = 0; c < CHANNELS; ++c) {
+                    out[i * CHANNELS + c] = sample;
+                }
+            }
+        }
+    }
+    
+    /**
+     * @brief Output hardware used by the audio engine
+     */
+    enum class OutputMode : uint8_t {
+        PWM,        ///< Timer interrupt writes one sample per tick (analogWrite)
+        DMA_PWM     ///< DMA streams blocks of PWM levels, one interrupt per block
+    };
+    
+    /**
+     * @brief Where the audio engine runs the user callback
+     */
+    enum class RenderMode : uint8_t {
+        INTERRUPT,  ///< Render inside the output interrupt on the calling core
+        DUAL_CORE   ///< Render on core1 and hand blocks to the output on core0
+    };
+    
+    /**
+     * @brief Measured timing of the sample clock
+     */
+    struct ClockStats {
+        float effective_rate = 0.0f;    ///< Samples per second actually output
+        float mean_jitter_us = 0.0f;    ///< Mean interrupt lateness vs. deadline (recent ticks weighted most)
+        uint32_t max_jitter_us = 0;     ///< Worst interrupt lateness vs. deadline
+        uint32_t late_ticks = 0;        ///< Samples output a full period or more after their deadline
+        uint32_t resyncs = 0;           ///< Times the clock fell too far behind and restarted from now
+        uint32_t ticks = 0;             ///< Samples output since the last reset
+    };
     
     /**
      * @brief Simple PWM audio output
      * 
      * Basic PWM-based audio output using Arduino's analogWrite().
-     * This is a simple implementation for initial testing.
-     * Future versions will use PIO for better performance.
+     * The timer alarm is scheduled at absolute deadlines advanced by a
+     * 32.32 fixed-point period, so the rate does not drift. The sample
+     * interrupt only copies precomputed levels: two blocks of levels
+     * alternate, and while one plays out a frame per tick, a lowest-priority
+     * interrupt pulls the next block from the source and converts it into
+     * the other. The tick preempts that render, so callback time does not
+     * stretch the period; a render that takes longer than a block holds
+     * the last level and counts an underrun.
+     * 
+     * With CHANNELS > 1 each channel drives its own pin; all pins are
+     * updated in the same tick from the same block. By default channel c
+     * uses pin 1 + c, so stereo lands on two PWM slices (GPIO 1 and 2).
      */
-    class PWMAudioOutput {
+    class PWMAudioOutput : public AudioOutput {
     private:
         static PWMAudioOutput* instance_;
         
-        uint8_t output_pin_ = 1;
+        static constexpr std::array<uint8_t, CHANNELS> defaultPins() {
+            std::array<uint8_t, CHANNELS> pins = {};
+            for (size_t c = 0; c < CHANNELS; ++c) {
+                pins[c] = static_cast<uint8_t>(1 + c);
+            }
+            return pins;
+        }
+        
+        std::array<uint8_t, CHANNELS> output_pins_ = defaultPins();
         uint32_t sample_rate_ = SAMPLE_RATE;
-        AudioCallback callback_ = nullptr;
         
-        // Timer variables
+        // Double-buffered levels: the tick plays levels_[playing_] one frame
+        // at a time while the render interrupt fills the other block
+        std::array<float, BLOCK_SIZE * CHANNELS> block_ = {};
+        std::array<std::array<uint16_t, BLOCK_SIZE * CHANNELS>, 2> levels_ = {};
+        std::atomic<bool> ready_[2] = {};       // Block rendered, not yet played
+        volatile uint8_t playing_ = 0;          // Written by the tick only
+        size_t block_pos_ = 0;
+        bool starved_ = false;                  // Holding the last level
+        volatile uint32_t underruns_ = 0;
+        int render_irq_ = -1;                   // Claimed user IRQ, -1 if none
+        std::array<PWM::BlockConverter, CHANNELS> converters_;
+        
+        // Timer variables (period and deadline in 32.32 fixed-point microseconds)
         volatile bool timer_active_ = false;
-        uint32_t timer_period_us_ = 0;
+        int alarm_num_ = -1;                    // Claimed hardware alarm, -1 if none
+        uint32_t period_us_ = 0;
+        uint32_t period_frac_ = 0;
+        uint64_t deadline_us_ = 0;
+        uint32_t deadline_frac_ = 0;
+        
+        // Written at the start of the next tick so rendering time adds no jitter;
+        // a pin is only written when its level changes
+        std::array<uint16_t, CHANNELS> pending_levels_ = {};
+        std::array<uint16_t, CHANNELS> written_levels_ = {};
+        
+        // Clock measurement
+        uint64_t stats_start_us_ = 0;
+        volatile uint32_t ticks_ = 0;
+        volatile uint32_t late_ticks_ = 0;
+        volatile uint32_t resyncs_ = 0;         // Catch-ups given up, periods dropped
+        volatile uint32_t max_jitter_us_ = 0;
+        volatile uint32_t jitter_sum_us_ = 0;   // Decayed sum of lateness
+        volatile uint32_t jitter_window_ = 0;   // Ticks in jitter_sum_us_
         
         // Sample conversion
-        static constexpr uint16_t PWM_RESOLUTION = 12;  // 12-bit PWM
-        static constexpr uint16_t PWM_MAX_VALUE = (1 << PWM_RESOLUTION) - 1;
-        static constexpr uint16_t PWM_CENTER = PWM_MAX_VALUE / 2;
+        static constexpr uint16_t PWM_RESOLUTION = PWM::RESOLUTION;  // 12-bit PWM
+        static constexpr uint16_t PWM_MAX_VALUE = PWM::MAX_VALUE;
+        static constexpr uint16_t PWM_CENTER = PWM::CENTER;
         
     public:
+        /**
+         * @brief Set a PWM output pin (call before begin())
+         * @param pin PWM output pin
+         * @param channel Channel the pin plays
+         */
+        void setOutputPin(uint8_t pin, size_t channel = 0) noexcept {
+            output_pins_[channel] = pin;
+        }
+        
         /**
          * @brief Initialize PWM audio output
          * @param pin PWM output pin
          * @param sample_rate Sample rate in Hz
          * @return true if initialization successful
          */
-        bool begin(uint8_t pin, uint32_t sample_rate);
+        bool begin(uint8_t pin, uint32_t sample_rate) {
+            setOutputPin(pin);
+            return begin(sample_rate);
+        }
         
         /**
-         * @brief Set audio callback function
-         * @param callback Function to call for each sample
+         * @brief Initialize PWM audio output on the configured pin
+         * @param sample_rate Sample rate in Hz
+         * @return true if initialization successful
          */
-        void setCallback(AudioCallback callback);
+        bool begin(uint32_t sample_rate) override;
         
         /**
          * @brief Stop audio output
          */
-        void end();
+        void end() override;
         
         /**
          * @brief Check if output is active
          * @return true if audio output is running
          */
-        bool isActive() const { return timer_active_; }
+        bool isActive() const override { return timer_active_; }
         
         /**
          * @brief Get current sample rate
          * @return Sample rate in Hz
          */
-        uint32_t getSampleRate() const { return sample_rate_; }
+        uint32_t getSampleRate() const override { return sample_rate_; }
+        
+        /**
+         * @brief One engine block per pull
+         */
+        size_t preferredBlockSize() const override { return BLOCK_SIZE; }
+        
+        /**
+         * @brief The block playing, the block rendered behind it and the
+         *        sample pending for the next tick
+         */
+        uint32_t latencyFrames() const override { return 2 * BLOCK_SIZE + 1; }
+        
+        /**
+         * @brief Block boundaries at which the next block was not rendered yet
+         */
+        uint32_t getUnderrunCount() const override { return underruns_; }
         
         /**
          * @brief Get output pin
+         * @param channel Channel to query
          * @return PWM output pin number
          */
-        uint8_t getOutputPin() const { return output_pin_; }
+        uint8_t getOutputPin(size_t channel = 0) const { return output_pins_[channel]; }
         
         /**
-         * @brief Write single sample to PWM output
+         * @brief Get measured sample rate and interrupt jitter
+         * @return Clock statistics since begin() or resetClockStats()
+         */
+        ClockStats getClockStats() const;
+        
+        /**
+         * @brief Restart clock measurement
+         */
+        void resetClockStats();
+        
+        /**
+         * @brief Block conversion settings (dither, DC blocker)
+         * @param channel Channel the converter serves
+         * @return Converter used for every rendered block
+         */
+        PWM::BlockConverter& getConverter(size_t channel = 0) { return converters_[channel]; }
+        
+        /**
+         * @brief Write single sample to every PWM output
          * @param sample Sample value (-1.0 to 1.0)
          */
         void writeSample(float sample);
@@ -101,12 +295,13 @@ namespace KoeKit {
          * @param sample Float sample (-1.0 to 1.0)
          * @return PWM value (0 to PWM_MAX_VALUE)
          */
-        static uint16_t sampleToPWM(float sample);
+        uint16_t sampleToPWM(float sample);
         
         /**
          * @brief Timer interrupt handler (static)
+         * @param alarm_num Hardware alarm that fired
          */
-        static void timerISR();
+        static void timerISR(unsigned int alarm_num);
         
         /**
          * @brief Timer interrupt handler (instance method)
@@ -114,8 +309,41 @@ namespace KoeKit {
         void handleTimerInterrupt();
         
         /**
-         * @brief Setup hardware timer
-         * @return true if timer setup successful
+         * @brief Output the pending sample and pick up the next one
+         * @param now_us Time the tick started
+         */
+        void tick(uint64_t now_us);
+        
+        /**
+         * @brief Render interrupt handler (static)
+         */
+        static void renderISR();
+        
+        /**
+         * @brief Pull a block from the source and convert it to levels
+         * @param index Level block to fill
+         */
+        void renderLevels(uint8_t index);
+        
+        /**
+         * @brief Claim a free user IRQ for rendering at the lowest priority
+         * @return false if none is free
+         */
+        bool setupRender();
+        
+        /**
+         * @brief Release the render IRQ
+         */
+        void stopRender();
+        
+        /**
+         * @brief Advance the absolute deadline by one sample period
+         */
+        void advanceDeadline();
+        
+        /**
+         * @brief Claim a free hardware alarm and start the timer
+         * @return false if no alarm is free or the first deadline was missed
          */
         bool setupTimer();
         
@@ -132,27 +360,382 @@ namespace KoeKit {
      * Manages oscillators, effects, and output.
      */
     class AudioEngine {
+        // Runs the engine on a file output without clearing the patch
+        friend class OfflineRenderer;
+        
     private:
         static AudioEngine* instance_;
-        PWMAudioOutput* output_ = nullptr;
-        AudioCallback user_callback_ = nullptr;
+        AudioOutput* output_ = nullptr;
         bool initialized_ = false;
+        RenderMode render_mode_ = RenderMode::INTERRUPT;
+        RenderStatsCollector stats_;
+        
+        // Internal-rate rendering: the callback runs at internal_rate_ and
+        // the resampler converts to the output rate
+        uint32_t internal_rate_ = 0;
+        ResampleQuality resample_quality_ = ResampleQuality::BALANCED;
+        Resampler resampler_;
+        bool resampling_ = false;
+        
+        // Oversampled rendering: the callback fills oversample_block_ at
+        // factor times the render rate and the decimator brings it down
+        Oversampling oversampling_ = Oversampling::X1;
+        std::atomic<Oversampling> requested_oversampling_{Oversampling::X1};
+        Decimator decimator_;
+        std::array<float, BLOCK_SIZE * CHANNELS * 4> oversample_block_ = {};
+        
+        // A factor change while running fades linearly from the old chain,
+        // which keeps its history and is fed the new render converted to
+        // its rate, to the new chain
+        Decimator fade_decimator_;
+        std::array<float, BLOCK_SIZE * CHANNELS * 4> fade_input_ = {};
+        uint32_t factor_fade_left_ = 0;
+        uint32_t factor_fade_hold_ = 0;         // Frames before the new chain fades in
+        float factor_fade_gain_ = 1.0f;         // Gain of the new chain
+        float factor_fade_step_ = 0.0f;
+        
+        // Parameter and event messages from loop(), applied between blocks
+        // or at their scheduled frame
+        ParamQueue params_;
+        std::atomic<uint32_t> frame_time_{0};   // Render frames since begin()
+        
+        // Overload protection, fed with the time of every block
+        LoadGovernor governor_;
+        
+        /**
+         * @brief One render function: per-sample or block callback
+         */
+        struct Patch {
+            AudioCallback callback = nullptr;
+            BlockCallback block_callback = nullptr;
+            ProcessCallback process_callback = nullptr;
+            void* block_context = nullptr;
+            
+            void render(const float* in, float* out, size_t frames);
+        };
+        
+        // Patch slots, swapped by index so the render context never copies
+        // a callback. loop() fills back_ and trades it for middle_; at a
+        // block boundary the render context trades retired_ for a new
+        // middle_, plays it as front_ and fades the old front_ out.
+        static constexpr uint8_t PATCH_DIRTY = 0x80;    // middle_ not played yet
+        std::array<Patch, 4> patches_ = {};
+        uint8_t back_ = 0;                      // Producer only
+        std::atomic<uint8_t> middle_{1};
+        uint8_t front_ = 2;                     // Render context only
+        uint8_t retired_ = 3;                   // Render context only
+        
+        // Equal-power crossfade from retired_ to front_: the gains are the
+        // cosine and sine of a phasor rotated once per frame
+        std::atomic<float> crossfade_seconds_{0.0f};
+        uint32_t fade_left_ = 0;
+        float fade_old_ = 0.0f;
+        float fade_new_ = 1.0f;
+        float fade_cos_ = 1.0f;
+        float fade_sin_ = 0.0f;
+        std::array<float, BLOCK_SIZE * CHANNELS> fade_block_ = {};
+        
+        // Captured input for process callbacks, read in place from the
+        // current input block
+        AudioInput* input_ = nullptr;
+        const float* input_block_ = nullptr;    // Block being read (or SILENT_BLOCK)
+        size_t input_pos_ = 0;                  // Frames already used from it
+        std::array<float, BLOCK_SIZE * CHANNELS * 4> input_hold_ = {};  // Oversampled input
+        
+        // Idle bypass: while the check reports silence the callback is not
+        // called and chunks are filled with zeros
+        IdleCheck idle_check_ = nullptr;
+        uint32_t idle_frames_ = 0;                  // Frames bypassed in a row
+        std::atomic<uint32_t> silent_frames_{0};    // Silent frames rendered in a row
+        
+        // Event log for loop(); the counters below are the totals already
+        // reported, so each block only logs what changed
+        TelemetryLog telemetry_;
+        struct TelemetryMarks {
+            uint32_t underruns = 0;
+            uint32_t overruns = 0;
+            uint32_t clips = 0;
+            uint32_t dropped = 0;
+            uint32_t late = 0;
+            uint32_t input_underruns = 0;
+            uint32_t input_skips = 0;
+            uint32_t timing_blocks = 0;
+            uint8_t level = 0;
+        } reported_;
+        
+        // Dual-core mode: core1 fills the ring, the output on core0 drains it
+        static constexpr size_t RING_BLOCK_SAMPLES = BLOCK_SIZE * CHANNELS;
+        BlockRing<float, RING_BLOCK_SAMPLES, KOEKIT_RENDER_BLOCKS> render_ring_;
+        const float* ring_block_ = nullptr;     // Ring block being copied out
+        size_t ring_pos_ = 0;                   // Samples already copied from it
+        std::atomic<bool> render_core_stop_{false};
+        std::atomic<bool> render_core_running_{false};
         
     public:
         /**
-         * @brief Initialize audio engine
+         * @brief Initialize audio engine on a built-in PWM output
          * @param sample_rate Sample rate in Hz
          * @param output_pin PWM output pin
+         * @param mode Output hardware (default: per-sample PWM)
          * @return true if initialization successful
          */
-        bool begin(uint32_t sample_rate = SAMPLE_RATE, uint8_t output_pin = 1);
+        bool begin(uint32_t sample_rate = SAMPLE_RATE, uint8_t output_pin = 1,
+                   OutputMode mode = OutputMode::PWM);
+        
+        /**
+         * @brief Initialize audio engine on any output backend
+         * 
+         * The engine becomes the output's source. In DUAL_CORE mode the
+         * output's preferred block must fit in the render ring.
+         * 
+         * @param output Output backend (must outlive the engine run)
+         * @param sample_rate Sample rate in Hz
+         * @return true if initialization successful
+         */
+        bool begin(AudioOutput& output, uint32_t sample_rate = SAMPLE_RATE);
+        
+        /**
+         * @brief Render straight from the active callback
+         * 
+         * Bypasses the output and the render ring; renders in chunks of at
+         * most BLOCK_SIZE frames. Used by outputs and host tools.
+         * 
+         * @param out Output buffer (frames * CHANNELS interleaved samples)
+         * @param frames Number of frames to render
+         */
+        void render(float* out, size_t frames);
         
         /**
          * @brief Set audio processing callback
+         * 
+         * Safe while the engine is running: the new callback is handed over
+         * wait-free and takes effect at the next block boundary.
+         * 
          * @param callback Function to generate audio samples
          */
         void setCallback(AudioCallback callback);
         
+        /**
+         * @brief Set block processing callback
+         * 
+         * Replaces any per-sample callback. The engine calls it with at
+         * most BLOCK_SIZE frames at a time and the output only moves the
+         * finished samples. Like setCallback(), safe while running.
+         * 
+         * @param callback Function to fill a block of audio samples
+         * @param context User pointer passed back to the callback
+         */
+        void setBlockCallback(BlockCallback callback, void* context = nullptr);
+        
+        /**
+         * @brief Set an effects callback that processes the captured input
+         * 
+         * Replaces any other callback, and is swapped in the same way. The
+         * callback receives the input set with setInput() (silence without
+         * one) frame-aligned with its output.
+         * 
+         * @param callback Function to turn a block of input into output
+         * @param context User pointer passed back to the callback
+         */
+        void setProcessCallback(ProcessCallback callback, void* context = nullptr);
+        
+        /**
+         * @brief Capture input for process callbacks
+         * 
+         * Call before begin(); ignored while the engine is running. begin()
+         * starts the input at the render rate and end() stops it. With
+         * oversampling, each input frame is held for factor frames.
+         * 
+         * @param input Input backend (must outlive the engine run), or nullptr
+         */
+        void setInput(AudioInput* input);
+        
+        /**
+         * @brief Skip rendering while the patch is idle
+         * 
+         * Call before begin(); ignored while the engine is running. Before
+         * each chunk, and after the parameter messages due at it have been
+         * applied, the engine asks the check; while it returns true the
+         * callback is not called and the chunk is filled with zeros. The
+         * check must cover every callback the sketch switches between, and
+         * should only report idle once the output has died away: an idle
+         * envelope with a filter still ringing after it cuts the tail.
+         * Crossfades always render.
+         * 
+         * @param check Idle check, or nullptr to always render
+         */
+        void setIdleCheck(IdleCheck check);
+        
+        /**
+         * @brief Render frames in a row that were digital silence
+         * 
+         * Counts every rendered block of exact zeros, whether or not the
+         * callback ran, and restarts at the first nonzero sample. loop()
+         * can use it to power down an amplifier, for instance.
+         * 
+         * @return Silent render frames (saturates)
+         */
+        uint32_t getSilentFrames() const {
+            return silent_frames_.load(std::memory_order_relaxed);
+        }
+        
+        /**
+         * @brief Crossfade between callbacks when one is replaced
+         * 
+         * With a nonzero time, a callback set while running fades in with
+         * equal-power gains while the previous one fades out; both run
+         * during the fade, so they should not share oscillators or other
+         * state. Further changes wait until the fade has finished, and only
+         * the latest one is played. 0 (default) swaps at the block boundary.
+         * 
+         * @param seconds Crossfade time
+         */
+        void setCrossfade(float seconds);
+        
+        /**
+         * @brief Choose where the callback runs
+         * 
+         * Call before begin(); ignored while the engine is running. In
+         * DUAL_CORE mode the callback runs on core1 and finished blocks reach
+         * the output through a wait-free ring of KOEKIT_RENDER_BLOCKS blocks
+         * (default 4), leaving core0 free for loop(). The sketch must not
+         * use setup1()/loop1().
+         * 
+         * @param mode Render mode
+         */
+        void setRenderMode(RenderMode mode);
+        
+        /**
+         * @brief Get the configured render mode
+         * @return Render mode
+         */
+        RenderMode getRenderMode() const { return render_mode_; }
+        
+        /**
+         * @brief Render at a fixed internal rate and resample to the output
+         * 
+         * Call before begin(); ignored while the engine is running. The
+         * callback then always runs at `rate`, whatever rate begin() picks
+         * for the output, and a polyphase resampler built in begin()
+         * converts to the output rate. Pass SAMPLE_RATE to keep objects
+         * that default to SAMPLE_RATE_F in tune; pass 0 to render at the
+         * output rate (default).
+         * 
+         * @param rate Internal rate in Hz, or 0 to disable
+         * @param quality Resampler quality / cost tradeoff
+         */
+        void setInternalRate(uint32_t rate, ResampleQuality quality = ResampleQuality::BALANCED);
+        
+        /**
+         * @brief Run the callback at 2x or 4x and decimate to the render rate
+         * 
+         * The callback is still called with at most BLOCK_SIZE frames, factor
+         * times as often; a cascade of half-band FIR filters removes
+         * everything above the render rate's band before decimating. Set
+         * oscillators and filters to getRenderRate(). While the engine is
+         * running the change takes effect at the next block, so a load
+         * policy can lower the factor and retune the patch in one step;
+         * the output fades from the old filters to the new ones over the
+         * crossfade time (at least BLOCK_SIZE frames), so the switch does
+         * not click.
+         * 
+         * @param factor Oversampling factor
+         */
+        void setOversampling(Oversampling factor);
+        
+        /**
+         * @brief Get the configured oversampling factor
+         * @return Oversampling factor
+         */
+        Oversampling getOversampling() const { return oversampling_; }
+        
+        /**
+         * @brief Rate the callback runs at
+         * @return Internal rate when set, otherwise the output rate, times
+         *         the oversampling factor
+         */
+        uint32_t getRenderRate() const;
+        
+        /**
+         * @brief Blocks the output needed but the renderer had not finished
+         * 
+         * Each underrun plays one block of silence.
+         * 
+         * @return Underrun count since begin()
+         */
+        uint32_t getUnderrunCount() const;
+        
+        /**
+         * @brief Blocks the renderer could not queue because the ring was full
+         * @return Overrun count since begin()
+         */
+        uint32_t getOverrunCount() const;
+        
+        /**
+         * @brief Parameter and event queue drained before every block
+         * @return Queue shared by loop() and the audio thread
+         */
+        ParamQueue& getParams() { return params_; }
+        
+        /**
+         * @brief Load governor fed with the render time of every block
+         * @return Governor to register policies and thresholds on
+         */
+        LoadGovernor& getGovernor() { return governor_; }
+        
+        /**
+         * @brief Event log written by the render context
+         * @return Log to enable record kinds on and drain from loop()
+         */
+        TelemetryLog& getTelemetry() { return telemetry_; }
+        
+        /**
+         * @brief Render frame the next block starts at
+         * 
+         * Counts frames at the render rate (before oversampling) since
+         * begin(). Stamp scheduled messages relative to it; what is heard
+         * trails it by getLatencyFrames() at the output rate.
+         * 
+         * @return Frame counter (wraps)
+         */
+        uint32_t getFrameTime() const {
+            return frame_time_.load(std::memory_order_relaxed);
+        }
+        
+        /**
+         * @brief Get render timing, CPU load and clipping
+         * 
+         * Every call into the user callback is timed with the cycle counter
+         * (RP2350) or steady_clock (host). A deadline miss is a call that
+         * took longer than the audio it produced lasts.
+         * 
+         * @return Statistics since begin() or resetStats()
+         */
+        RenderStats getStats() const;
+        
+        /**
+         * @brief Clear render statistics and the output's clip count
+         */
+        void resetStats();
+        
+        /**
+         * @brief Frames between rendering a sample and hearing it
+         * @return Output latency plus render ring latency in DUAL_CORE mode
+         */
+        uint32_t getLatencyFrames() const;
+        
+        /**
+         * @brief Frames between a sample reaching the input and hearing it
+         * @return getLatencyFrames() plus the input's latency, at the output rate
+         */
+        uint32_t getRoundTripLatencyFrames() const;
+        
+        /**
+         * @brief Get the running output backend
+         * @return Output, or nullptr when stopped
+         */
+        AudioOutput* getOutput() const { return output_; }
+        
         /**
          * @brief Stop audio engine
          */
@@ -178,10 +761,113 @@ namespace KoeKit {
         
     private:
         /**
-         * @brief Internal audio callback wrapper
-         * @return Generated audio sample
+         * @brief Fill a buffer from the active user callback
+         * @param out Output buffer (frames * CHANNELS samples)
+         * @param frames Number of frames to render
+         */
+        void renderBlock(float* out, size_t frames);
+        
+        /**
+         * @brief Call the user callback in pieces of at most BLOCK_SIZE frames
+         * @return true if the idle check bypassed every piece
+         */
+        bool runCallback(const float* in, float* out, size_t frames);
+        
+        /**
+         * @brief Take the next run of captured input frames
+         * @param frames Frames wanted; shortened to the end of the input block
+         * @param factor Oversampling factor (input frames are held this long)
+         * @return Input at the callback rate
+         */
+        const float* readInput(size_t& frames, size_t factor);
+        
+        /**
+         * @brief Scan a finished block and log what changed (render context only)
+         * @param out Finished block (non-finite samples are silenced)
+         * @param frames Frames in the block
+         * @param frame Render frame of its start
+         * @param elapsed Ticks it took to render
+         */
+        void reportTelemetry(float* out, size_t frames, uint32_t frame, uint32_t elapsed);
+        
+        /**
+         * @brief Log the growth of a counter since it was last reported
+         */
+        void reportCount(TelemetryEvent type, uint32_t count, uint32_t& reported, uint32_t frame);
+        
+        /**
+         * @brief Hand the filled back slot to the render context (producer side)
          */
-        float audioCallback();
+        void publishPatch();
+        
+        /**
+         * @brief Stop the output, render core and input; end() also clears the patch
+         */
+        void stop();
+        
+        /**
+         * @brief Start playing a newly published patch (render context only)
+         */
+        void swapPatch();
+        
+        /**
+         * @brief Switch to a new oversampling factor under a fade (render context only)
+         * @param factor Factor to switch to
+         */
+        void beginFactorFade(Oversampling factor);
+        
+        /**
+         * @brief Mix the old decimation chain into a block while fading
+         * @param rendered Block as rendered at the new factor
+         * @param factor New factor as a number
+         * @param out Block decimated by the new chain
+         * @param frames Frames in the block (at most BLOCK_SIZE)
+         */
+        void fadeFactor(const float* rendered, size_t factor, float* out, size_t frames);
+        
+        /**
+         * @brief Mix the retired patch into a rendered chunk while fading
+         * @param in Input of the chunk (nullptr for silence)
+         * @param out Chunk rendered by the front patch
+         * @param frames Frames in the chunk (at most BLOCK_SIZE)
+         */
+        void crossfade(const float* in, float* out, size_t frames);
+        
+        /**
+         * @brief Copy finished samples out of the render ring
+         * 
+         * Releases each ring block as soon as it has been copied; plays
+         * silence on underrun.
+         * 
+         * @param out Output buffer (frames * CHANNELS samples)
+         * @param frames Number of frames to copy
+         */
+        void readRing(float* out, size_t frames);
+        
+        /**
+         * @brief Block source trampoline installed on the output
+         */
+        static void renderBlockThunk(float* out, size_t frames, void* context);
+        
+        /**
+         * @brief Rendered blocks at the render rate (ring or inline)
+         */
+        static void renderSource(float* out, size_t frames, void* context);
+        
+        /**
+         * @brief Launch the render loop on core1 and wait for a full ring
+         */
+        void startRenderCore();
+        
+        /**
+         * @brief Stop the render loop and reset core1
+         */
+        void stopRenderCore();
+        
+        /**
+         * @brief Render loop run on core1
+         */
+        static void renderCoreEntry();
     };
     
     // Global functions for easy access
@@ -190,9 +876,19 @@ namespace KoeKit {
      * @brief Initialize KoeKit audio system
      * @param sample_rate Sample rate in Hz
      * @param output_pin PWM output pin
+     * @param mode Output hardware (default: per-sample PWM)
+     * @return true if initialization successful
+     */
+    bool begin(uint32_t sample_rate = SAMPLE_RATE, uint8_t output_pin = 1,
+               OutputMode mode = OutputMode::PWM);
+    
+    /**
+     * @brief Initialize KoeKit audio system on an output backend
+     * @param output Output backend
+     * @param sample_rate Sample rate in Hz
      * @return true if initialization successful
      */
-    bool begin(uint32_t sample_rate = SAMPLE_RATE, uint8_t output_pin = 1);
+    bool begin(AudioOutput& output, uint32_t sample_rate = SAMPLE_RATE);
     
     /**
      * @brief Set audio processing callback
@@ -200,6 +896,192 @@ namespace KoeKit {
      */
     void setAudioCallback(AudioCallback callback);
     
+    /**
+     * @brief Set block processing callback
+     * @param callback Function to fill a block of audio samples
+     * @param context User pointer passed back to the callback
+     */
+    void setBlockCallback(BlockCallback callback, void* context = nullptr);
+    
+    /**
+     * @brief Set an effects callback that processes the captured input
+     * @param callback Function to turn a block of input into output
+     * @param context User pointer passed back to the callback
+     */
+    void setProcessCallback(ProcessCallback callback, void* context = nullptr);
+    
+    /**
+     * @brief Capture input for process callbacks (call before begin())
+     * @param input Input backend, or nullptr for none
+     */
+    void setInput(AudioInput* input);
+    
+    /**
+     * @brief Crossfade between callbacks when one is replaced
+     * @param seconds Crossfade time, or 0 to swap at the block boundary
+     */
+    void setCrossfade(float seconds);
+    
+    /**
+     * @brief Skip rendering while the patch is idle (call before begin())
+     * @param check Returns true while every voice is silent, or nullptr
+     */
+    void setIdleCheck(IdleCheck check);
+    
+    /**
+     * @brief Render frames in a row that were digital silence
+     * @return Silent render frames (saturates)
+     */
+    uint32_t getSilentFrames();
+    
+    namespace Detail {
+        /**
+         * @brief Block renderer instantiated per callable type
+         * 
+         * The callable's body is visible here, so the compiler can inline it
+         * straight into the loop.
+         */
+        template<typename F>
+        void renderInline(float* out, size_t frames, void* context) {
+            F& callback = *static_cast<F*>(context);
+            for (size_t i = 0; i < frames; ++i) {
+                writeFrame(out, i, callback());
+            }
+        }
+    }
+    
+    /**
+     * @brief Set a stateless audio callback rendered without indirect calls
+     * 
+     * Chosen automatically for captureless lambdas. The lambda is compiled
+     * into its own block renderer, so there is no per-sample call through
+     * a function pointer. Capturing lambdas use the AudioCallback overload.
+     * 
+     * @param callback Captureless lambda returning float samples
+     */
+    template<typename F,
+             typename Fn = std::decay_t<F>,
+             typename = std::enable_if_t<std::is_empty_v<Fn> &&
+                                         std::is_invocable_r_v<float, Fn&>>>
+    void setAudioCallback(F&& callback) {
+        // Stateless: every instance of Fn behaves the same, one copy is enough
+        static Fn stored = std::forward<F>(callback);
+        setBlockCallback(&Detail::renderInline<Fn>, &stored);
+    }
+    
+    /**
+     * @brief Choose where the callback runs (call before begin())
+     * @param mode Render mode
+     */
+    void setRenderMode(RenderMode mode);
+    
+    /**
+     * @brief Render at a fixed rate and resample to the output (call before begin())
+     * @param rate Internal rate in Hz, or 0 to render at the output rate
+     * @param quality Resampler quality / cost tradeoff
+     */
+    void setInternalRate(uint32_t rate, ResampleQuality quality = ResampleQuality::BALANCED);
+    
+    /**
+     * @brief Run the callback at 2x or 4x the render rate
+     * @param factor Oversampling factor
+     */
+    void setOversampling(Oversampling factor);
+    
+    /**
+     * @brief Register a parameter applied on the audio thread
+     * 
+     * Call from setup(). Updates posted with setParameter() are applied
+     * between blocks; repeated updates before a block collapse into one.
+     * 
+     * @param handler Called with the latest value (lambdas may capture references)
+     * @return Parameter id, or INVALID_PARAM if none is left
+     */
+    ParamId addParameter(ParamHandler handler);
+    
+    /**
+     * @brief Register an event handled on the audio thread
+     * @param handler Called once per event with its value
+     * @return Event id, or INVALID_PARAM if none is left
+     */
+    ParamId addEvent(ParamHandler handler);
+    
+    /**
+     * @brief Post a parameter value from loop() (wait-free)
+     * @param id Parameter id
+     * @param value New value
+     * @return false if the id is unknown or the queue is full
+     */
+    bool setParameter(ParamId id, float value);
+    
+    /**
+     * @brief Post an event from loop() (wait-free)
+     * @param id Event id
+     * @param value Event argument
+     * @return false if the id is unknown or the queue is full
+     */
+    bool sendEvent(ParamId id, float value = 1.0f);
+    
+    /**
+     * @brief Add a record to the telemetry log (audio context only)
+     * 
+     * Wait-free and allocation-free; stamped with the current block's
+     * render frame. Use VOICE_STEAL, or userEvent(n) for sketch-defined
+     * kinds.
+     * 
+     * @param type Record kind
+     * @param arg Small argument (voice, channel, ...)
+     * @param value Count or measurement (saturated to 16 bits)
+     * @return false if the kind is disabled or the log is full
+     */
+    bool logEvent(TelemetryEvent type, uint8_t arg = 0, uint32_t value = 0);
+    
+    /**
+     * @brief Take records out of the telemetry log (call from loop())
+     * @param out Destination array
+     * @param max_records Size of the array
+     * @return Number of records copied
+     */
+    size_t drainTelemetry(TelemetryRecord* out, size_t max_records);
+    
+    /**
+     * @brief Register an overload policy (call from setup())
+     * 
+     * When render time nears the block budget, the engine lowers quality
+     * one level at a time, policy by policy in registration order, and
+     * restores it when headroom returns. The handler runs on the audio
+     * thread between blocks.
+     * 
+     * @param handler Called with the new level (0 = full quality)
+     * @param levels Number of cheaper levels
+     * @return false if no policy slot is left
+     */
+    bool addLoadPolicy(LoadPolicyHandler handler, uint8_t levels = 1);
+    
+    /**
+     * @brief Apply a parameter value at an exact render frame (wait-free)
+     * @param id Parameter id
+     * @param value New value
+     * @param frame Render frame (see getFrameTime())
+     * @return false if the id is unknown or the queue is full
+     */
+    bool setParameterAt(ParamId id, float value, uint32_t frame);
+    
+    /**
+     * @brief Send an event at an exact render frame (wait-free)
+     * @param id Event id
+     * @param value Event argument
+     * @param frame Render frame (see getFrameTime())
+     * @return false if the id is unknown or the queue is full
+     */
+    bool sendEventAt(ParamId id, float value, uint32_t frame);
+    
+    /**
+     * @brief Render frame the next block starts at
+     * @return Frame counter (wraps)
+     */
+    uint32_t getFrameTime();
+    
     /**
      * @brief Stop KoeKit audio system
      */
@@ -210,7 +1092,7 @@ namespace KoeKit {
      * @return Sample rate in Hz
      */
     uint32_t getSampleRate();
-    
+
 } // namespace KoeKit
 
 #endif // KOEKIT_AUDIO_OUTPUT_H
\ No newline at end of file
@@ -0,0 +1,173 @@
+#pragma once
+
+/**
+ * @file block_ring.h
+ * @brief Single-producer/single-consumer ring of fixed-size audio blocks
+ */
+
+#ifndef KOEKIT_BLOCK_RING_H
+#define KOEKIT_BLOCK_RING_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace KoeKit {
+    
+    /**
+     * @brief Ring of audio blocks shared by one producer and one consumer
+     *
+     * Blocks are filled and consumed in place, so no samples are copied
+     * through the ring. The producer and consumer each own one counter and
+     * never wait on each other. Only depends on the standard library, so the
+     * buffer handling can be exercised on a host.
+     *
+     * @tparam T Sample type stored in the blocks
+     * @tparam BLOCK_FRAMES Samples per block
+     * @tparam NUM_BLOCKS Number of blocks (power of two, at least 2)
+     */
+    template<typename T, size_t BLOCK_FRAMES, size_t NUM_BLOCKS>
+    class BlockRing {
+        static_assert(NUM_BLOCKS >= 2 && (NUM_BLOCKS & (NUM_BLOCKS - 1)) == 0,
+                      "NUM_BLOCKS must be a power of two");
+        
+    public:
+        using Block = std::array<T, BLOCK_FRAMES>;
+        
+    private:
+        static constexpr uint32_t INDEX_MASK = NUM_BLOCKS - 1;
+        
+        std::array<Block, NUM_BLOCKS> blocks_ = {};
+        std::atomic<uint32_t> write_count_{0};   // Blocks committed by the producer
+        std::atomic<uint32_t> read_count_{0};    // Blocks released by the consumer
+        std::atomic<uint32_t> overruns_{0};      // Written by the producer only
+        std::atomic<uint32_t> underruns_{0};     // Written by the consumer only
+        
+    public:
+        //---------------------------------------------------------------------
+        // Producer side
+        //---------------------------------------------------------------------
+        
+        /**
+         * @brief Get the next free block to fill
+         * 
+         * A full ring counts as an overrun. Producers that may run ahead
+         * should check writable() first and wait instead.
+         * 
+         * @return Pointer to BLOCK_FRAMES samples, or nullptr if the ring is full
+         */
+        T* acquireWrite() noexcept {
+            const uint32_t write = write_count_.load(std::memory_order_relaxed);
+            const uint32_t read = read_count_.load(std::memory_order_acquire);
+            if (write - read >= NUM_BLOCKS) {
+                overruns_.store(overruns_.load(std::memory_order_relaxed) + 1,
+                                std::memory_order_relaxed);
+                return nullptr;
+            }
+            return blocks_[write & INDEX_MASK].data();
+        }
+        
+        /**
+         * @brief Publish the block returned by acquireWrite()
+         */
+        void commitWrite() noexcept {
+            const uint32_t write = write_count_.load(std::memory_order_relaxed);
+            write_count_.store(write + 1, std::memory_order_release);
+        }
+        
+        //---------------------------------------------------------------------
+        // Consumer side
+        //---------------------------------------------------------------------
+        
+        /**
+         * @brief Get the oldest filled block for playback
+         * 
+         * An empty ring counts as an underrun. Call releaseRead() once the
+         * block has been played.
+         * 
+         * @return Pointer to BLOCK_FRAMES samples, or nullptr if none is ready
+         */
+        const T* acquireRead() noexcept {
+            const T* block = peekRead(0);
+            if (block == nullptr) {
+                underruns_.store(underruns_.load(std::memory_order_relaxed) + 1,
+                                 std::memory_order_relaxed);
+            }
+            return block;
+        }
+        
+        /**
+         * @brief Get a filled block without releasing it
+         * @param offset 0 for the oldest filled block, 1 for the next, ...
+         * @return Pointer to BLOCK_FRAMES samples, or nullptr if not yet filled
+         */
+        const T* peekRead(size_t offset = 0) const noexcept {
+            const uint32_t read = read_count_.load(std::memory_order_relaxed);
+            const uint32_t write = write_count_.load(std::memory_order_acquire);
+            if (write - read <= offset) {
+                return nullptr;
+            }
+            return blocks_[(read + offset) & INDEX_MASK].data();
+        }
+        
+        /**
+         * @brief Return the oldest filled block to the producer
+         */
+        void releaseRead() noexcept {
+            const uint32_t read = read_count_.load(std::memory_order_relaxed);
+            read_count_.store(read + 1, std::memory_order_release);
+        }
+        
+        //---------------------------------------------------------------------
+        // Status
+        //---------------------------------------------------------------------
+        
+        /**
+         * @brief Number of filled blocks not yet released
+         */
+        size_t readable() const noexcept {
+            return write_count_.load(std::memory_order_acquire) -
+                   read_count_.load(std::memory_order_acquire);
+        }
+        
+        /**
+         * @brief Number of blocks the producer can fill
+         */
+        size_t writable() const noexcept {
+            return NUM_BLOCKS - readable();
+        }
+        
+        /**
+         * @brief Times the producer found the ring full
+         */
+        uint32_t overruns() const noexcept {
+            return overruns_.load(std::memory_order_relaxed);
+        }
+        
+        /**
+         * @brief Times the consumer found the ring empty
+         */
+        uint32_t underruns() const noexcept {
+            return underruns_.load(std::memory_order_relaxed);
+        }
+        
+        /**
+         * @brief Drop all blocks and clear the counters
+         * 
+         * Only while producer and consumer are stopped.
+         */
+        void reset() noexcept {
+            write_count_.store(0, std::memory_order_relaxed);
+            read_count_.store(0, std::memory_order_relaxed);
+            overruns_.store(0, std::memory_order_relaxed);
+            underruns_.store(0, std::memory_order_relaxed);
+        }
+        
+        static constexpr size_t blockFrames() noexcept { return BLOCK_FRAMES; }
+        static constexpr size_t numBlocks() noexcept { return NUM_BLOCKS; }
+    };
+
+} // namespace KoeKit
+
+#endif // KOEKIT_BLOCK_RING_H
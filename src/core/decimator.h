@@ -0,0 +1,223 @@
+#pragma once
+
+/**
+ * @file decimator.h
+ * @brief Half-band decimators for oversampled rendering in KoeKit
+ */
+
+#ifndef KOEKIT_DECIMATOR_H
+#define KOEKIT_DECIMATOR_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace KoeKit {
+    
+    /**
+     * @brief Oversampling factor for the render callback
+     */
+    enum class Oversampling : uint8_t {
+        X1 = 1,     ///< Render at the output rate (default)
+        X2 = 2,     ///< Render at twice the output rate
+        X4 = 4      ///< Render at four times the output rate
+    };
+    
+    namespace Detail {
+        // Kaiser-windowed (beta 7) half-band designs, odd-offset taps only;
+        // the center tap is 0.5 and every even offset is zero.
+        
+        // 15 taps: passes 0.1125 fs, rejects 0.3875 fs by 64 dB. Enough for
+        // the 4x -> 2x stage, whose aliases land above the final passband.
+        inline constexpr std::array<float, 4> HALFBAND_SHORT = {
+            0.3024108753f, -0.0662028147f, 0.0156041760f, -0.0018122366f
+        };
+        
+        // 47 taps: passes 0.2 fs, rejects 0.3 fs by 70 dB
+        inline constexpr std::array<float, 12> HALFBAND_LONG = {
+            0.3165601023f, -0.1008596125f, 0.0552394979f, -0.0343316677f,
+            0.0220798615f, -0.0141308582f, 0.0087871844f, -0.0052042809f,
+            0.0028707598f, -0.0014283093f, 0.0006044144f, -0.0001870915f
+        };
+    }
+    
+    /**
+     * @brief Polyphase half-band FIR decimator by 2
+     *
+     * A half-band filter has every even-offset tap zero except the center,
+     * and the rest are symmetric. Split into even and odd input phases, one
+     * output costs PAIRS multiplies and the center tap: the odd phase is a
+     * pure delay. Works on CHANNELS interleaved channels.
+     *
+     * @tparam PAIRS Number of nonzero tap pairs (4 * PAIRS - 1 taps)
+     */
+    template<size_t PAIRS>
+    class HalfBandDecimator {
+    private:
+        const std::array<float, PAIRS>* coeffs_;   // Pointer, so the state can be copied
+        
+        // Even phase: ring of the last 2 * PAIRS inputs, written twice so
+        // the window is always contiguous
+        std::array<std::array<float, 4 * PAIRS>, CHANNELS> even_ = {};
+        // Odd phase: delay line of PAIRS inputs
+        std::array<std::array<float, PAIRS>, CHANNELS> odd_ = {};
+        size_t even_pos_ = 0;
+        size_t odd_pos_ = 0;
+        
+    public:
+        explicit HalfBandDecimator(const std::array<float, PAIRS>& coeffs) : coeffs_(&coeffs) {}
+        
+        /**
+         * @brief Clear the filter state
+         */
+        void reset() {
+            for (auto& line : even_) {
+                line.fill(0.0f);
+            }
+            for (auto& line : odd_) {
+                line.fill(0.0f);
+            }
+            even_pos_ = 0;
+            odd_pos_ = 0;
+        }
+        
+        /**
+         * @brief Decimate by two
+         * @param in Input (2 * frames * CHANNELS samples)
+         * @param out Output (frames * CHANNELS samples, may alias in)
+         * @param frames Number of output frames
+         */
+        void process(const float* in, float* out, size_t frames) {
+            for (size_t n = 0; n < frames; ++n) {
+                const float* even_in = in + 2 * n * CHANNELS;
+                const float* odd_in = even_in + CHANNELS;
+                even_pos_ = (even_pos_ + 1) % (2 * PAIRS);
+                
+                for (size_t c = 0; c < CHANNELS; ++c) {
+                    float* ring = even_[c].data();
+                    ring[even_pos_] = even_in[c];
+                    ring[even_pos_ + 2 * PAIRS] = even_in[c];
+                    
+                    // Oldest sample first; the pair for tap k sits at
+                    // PAIRS - 1 - k and PAIRS + k
+                    const float* w = ring + even_pos_ + 1;
+                    const std::array<float, PAIRS>& coeffs = *coeffs_;
+                    float acc = 0.0f;
+                    for (size_t k = 0; k < PAIRS; ++k) {
+                        acc += coeffs[k] * (w[PAIRS - 1 - k] + w[PAIRS + k]);
+                    }
+                    
+                    float& delayed = odd_[c][odd_pos_];
+                    const float center = delayed;
+                    delayed = odd_in[c];
+                    
+                    out[n * CHANNELS + c] = acc + 0.5f * center;
+                }
+                odd_pos_ = (odd_pos_ + 1) % PAIRS;
+            }
+        }
+        
+        /**
+         * @brief Delay in input frames
+         */
+        static constexpr size_t latencyFrames() { return 2 * PAIRS - 1; }
+        
+        /**
+         * @brief Output frames of silent input that leave the state all zero
+         */
+        static constexpr size_t settleFrames() { return 2 * PAIRS; }
+    };
+    
+    /**
+     * @brief 2x or 4x half-band decimation cascade
+     *
+     * 4x goes through a short stage to 2x first, then both factors share
+     * the long 2x -> 1x stage. Blocks of up to BLOCK_SIZE output frames.
+     */
+    class Decimator {
+    private:
+        HalfBandDecimator<Detail::HALFBAND_SHORT.size()> first_{Detail::HALFBAND_SHORT};
+        HalfBandDecimator<Detail::HALFBAND_LONG.size()> last_{Detail::HALFBAND_LONG};
+        std::array<float, 2 * BLOCK_SIZE * CHANNELS> scratch_ = {};
+        Oversampling factor_ = Oversampling::X1;
+        
+    public:
+        /**
+         * @brief Select the factor and clear the filter state
+         * @param factor Oversampling factor
+         */
+        void begin(Oversampling factor) {
+            factor_ = factor;
+            reset();
+        }
+        
+        /**
+         * @brief Clear the filter state
+         */
+        void reset() {
+            first_.reset();
+            last_.reset();
+        }
+        
+        /**
+         * @brief Decimate one block
+         * @param in Input (factor * frames * CHANNELS samples)
+         * @param out Output (frames * CHANNELS samples)
+         * @param frames Output frames (at most BLOCK_SIZE)
+         */
+        void process(const float* in, float* out, size_t frames) {
+            switch (factor_) {
+                case Oversampling::X1:
+                    std::copy(in, in + frames * CHANNELS, out);
+                    break;
+                case Oversampling::X2:
+                    last_.process(in, out, frames);
+                    break;
+                case Oversampling::X4:
+                    first_.process(in, scratch_.data(), 2 * frames);
+                    last_.process(scratch_.data(), out, frames);
+                    break;
+            }
+        }
+        
+        /**
+         * @brief Oversampling factor as a number
+         */
+        size_t factor() const { return static_cast<size_t>(factor_); }
+        
+        /**
+         * @brief Output frames of silent input after which the output is
+         *        silent and the state all zero
+         */
+        size_t settleFrames() const {
+            switch (factor_) {
+                case Oversampling::X2:
+                    return decltype(last_)::settleFrames();
+                case Oversampling::X4:
+                    return decltype(first_)::settleFrames() / 2 + 1 +
+                           decltype(last_)::settleFrames();
+                default:
+                    return 0;
+            }
+        }
+        
+        /**
+         * @brief Delay in output frames (rounded down)
+         */
+        size_t latencyFrames() const {
+            switch (factor_) {
+                case Oversampling::X2:
+                    return decltype(last_)::latencyFrames() / 2;
+                case Oversampling::X4:
+                    return (decltype(first_)::latencyFrames() / 2 +
+                            decltype(last_)::latencyFrames()) / 2;
+                default:
+                    return 0;
+            }
+        }
+    };
+
+} // namespace KoeKit
+
+#endif // KOEKIT_DECIMATOR_H
@@ -0,0 +1,158 @@
+/**
+ * @file dma_pwm_output.cpp
+ * @brief RP2350 DMA transport for the DMA-fed PWM output
+ */
+
+#include "../KoeKit.h"
+
+#if defined(ARDUINO_ARCH_RP2040)
+
+#include "hardware/clocks.h"
+#include "hardware/dma.h"
+#include "hardware/gpio.h"
+#include "hardware/irq.h"
+#include "hardware/pwm.h"
+
+namespace KoeKit {
+    
+    // Static member initialization
+    RP2DMATransport* RP2DMATransport::instance_ = nullptr;
+    
+    //=============================================================================
+    // RP2DMATransport Implementation
+    //=============================================================================
+    
+    RP2DMATransport& RP2DMATransport::getInstance() {
+        if (instance_ == nullptr) {
+            static RP2DMATransport instance;
+            instance_ = &instance;
+        }
+        return *instance_;
+    }
+    
+    bool RP2DMATransport::begin(uint8_t pin, uint32_t sample_rate, size_t block_frames) {
+        block_frames_ = block_frames;
+        
+        // Claim everything that can fail before touching the PWM; on failure
+        // end() releases only what was claimed
+        dma_timer_ = dma_claim_unused_timer(false);
+        if (dma_timer_ < 0) {
+            return false;
+        }
+        for (int i = 0; i < 2; ++i) {
+            dma_channels_[i] = dma_claim_unused_channel(false);
+            if (dma_channels_[i] < 0) {
+                end();
+                return false;
+            }
+        }
+        
+        // PWM carrier runs at full speed; DMA updates the level at the sample rate
+        pin_ = pin;
+        gpio_set_function(pin_, GPIO_FUNC_PWM);
+        const uint slice = pwm_gpio_to_slice_num(pin_);
+        pwm_config config = pwm_get_default_config();
+        pwm_config_set_wrap(&config, PWM::MAX_VALUE);
+        pwm_config_set_clkdiv(&config, 1.0f);
+        pwm_init(slice, &config, true);
+        pwm_set_gpio_level(pin_, PWM::CENTER);
+        
+        // Pace transfers with a DMA timer: rate = clk_sys * X / Y (16-bit X, Y)
+        const double sys_hz = static_cast<double>(clock_get_hz(clk_sys));
+        uint16_t best_x = 1;
+        uint16_t best_y = 0xFFFF;
+        double best_error = 1e30;
+        for (uint32_t x = 1; x <= 0xFFFF; ++x) {
+            const double y = std::round(sys_hz * x / sample_rate);
+            if (y > 0xFFFF) {
+                break;
+            }
+            const double error = std::abs(sys_hz * x / y - sample_rate);
+            if (error < best_error) {
+                best_error = error;
+                best_x = static_cast<uint16_t>(x);
+                best_y = static_cast<uint16_t>(y);
+            }
+        }
+        dma_timer_set_fraction(dma_timer_, best_x, best_y);
+        
+        // Two channels chained to each other play alternate blocks
+        volatile void* cc = &pwm_hw->slice[slice].cc;
+        for (int i = 0; i < 2; ++i) {
+            dma_channel_config c = dma_channel_get_default_config(dma_channels_[i]);
+            channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+            channel_config_set_read_increment(&c, true);
+            channel_config_set_write_increment(&c, false);
+            channel_config_set_dreq(&c, dma_get_timer_dreq(dma_timer_));
+            channel_config_set_chain_to(&c, dma_channels_[i ^ 1]);
+            dma_channel_configure(dma_channels_[i], &c, cc, nullptr, block_frames_, false);
+            dma_channel_set_irq0_enabled(dma_channels_[i], true);
+        }
+        
+        instance_ = this;
+        irq_add_shared_handler(DMA_IRQ_0, dmaISR, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+        handler_installed_ = true;
+        irq_set_enabled(DMA_IRQ_0, true);
+        return true;
+    }
+    
+    void RP2DMATransport::start(const uint16_t* first, const uint16_t* second) {
+        dma_channel_set_read_addr(dma_channels_[1], second, false);
+        dma_channel_set_read_addr(dma_channels_[0], first, true);
+    }
+    
+    void RP2DMATransport::queue(uint8_t half, const uint16_t* block) {
+        // Re-armed, not triggered: the other channel chains into it when done
+        dma_channel_set_trans_count(dma_channels_[half], block_frames_, false);
+        dma_channel_set_read_addr(dma_channels_[half], block, false);
+    }
+    
+    void RP2DMATransport::end() {
+        for (int i = 0; i < 2; ++i) {
+            if (dma_channels_[i] >= 0) {
+                dma_channel_set_irq0_enabled(dma_channels_[i], false);
+            }
+        }
+        for (int i = 0; i < 2; ++i) {
+            if (dma_channels_[i] >= 0) {
+                dma_channel_abort(dma_channels_[i]);
+                dma_channel_acknowledge_irq0(dma_channels_[i]);
+                dma_channel_unclaim(dma_channels_[i]);
+                dma_channels_[i] = -1;
+            }
+        }
+        if (dma_timer_ >= 0) {
+            dma_timer_unclaim(dma_timer_);
+            dma_timer_ = -1;
+        }
+        if (handler_installed_) {
+            irq_remove_handler(DMA_IRQ_0, dmaISR);
+            handler_installed_ = false;
+        }
+        
+        // Set output to center (silence)
+        if (pin_ != 255) {
+            pwm_set_gpio_level(pin_, PWM::CENTER);
+            pin_ = 255;
+        }
+    }
+    
+    void RP2DMATransport::dmaISR() {
+        if (instance_ != nullptr) {
+            instance_->handleDMAInterrupt();
+        }
+    }
+    
+    void RP2DMATransport::handleDMAInterrupt() {
+        for (uint8_t half = 0; half < 2; ++half) {
+            const int channel = dma_channels_[half];
+            if (channel >= 0 && dma_channel_get_irq0_status(channel)) {
+                dma_channel_acknowledge_irq0(channel);
+                notifyComplete(half);
+            }
+        }
+    }
+
+} // namespace KoeKit
+
+#endif // ARDUINO_ARCH_RP2040
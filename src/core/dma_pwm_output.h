@@ -0,0 +1,408 @@
+#pragma once
+
+/**
+ * @file dma_pwm_output.h
+ * @brief DMA-fed PWM audio output for KoeKit
+ */
+
+#ifndef KOEKIT_DMA_PWM_OUTPUT_H
+#define KOEKIT_DMA_PWM_OUTPUT_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "audio_backend.h"
+#include "block_ring.h"
+#include "pwm_convert.h"
+
+#ifndef KOEKIT_DMA_BLOCKS
+#define KOEKIT_DMA_BLOCKS 4
+#endif
+
+namespace KoeKit {
+    
+    /**
+     * @brief Hardware side of the DMA PWM output
+     *
+     * Streams blocks of PWM levels into the PWM compare register at the
+     * sample rate using two alternating ("ping-pong") transfers: while one
+     * half plays, the other holds the next block. The completion handler is
+     * called once per finished block with the half that became free.
+     */
+    class DMATransport {
+    public:
+        using CompleteHandler = void (*)(void* context, uint8_t half);
+        
+        virtual ~DMATransport() = default;
+        
+        /**
+         * @brief Configure PWM pin, DMA pacing and channels
+         * @param pin PWM output pin
+         * @param sample_rate Sample rate in Hz
+         * @param block_frames Samples per block
+         * @return true if the hardware could be claimed
+         */
+        virtual bool begin(uint8_t pin, uint32_t sample_rate, size_t block_frames) = 0;
+        
+        /**
+         * @brief Start streaming with both halves primed
+         * @param first Block played first (half 0)
+         * @param second Block played next (half 1)
+         */
+        virtual void start(const uint16_t* first, const uint16_t* second) = 0;
+        
+        /**
+         * @brief Queue a block on a half that has completed
+         * @param half Half reported to the completion handler
+         * @param block Block of PWM levels to play after the other half
+         */
+        virtual void queue(uint8_t half, const uint16_t* block) = 0;
+        
+        /**
+         * @brief Stop streaming and release the hardware
+         */
+        virtual void end() = 0;
+        
+        /**
+         * @brief Set block completion handler
+         * @param handler Function called from the completion interrupt
+         * @param context User pointer passed back to the handler
+         */
+        void setCompleteHandler(CompleteHandler handler, void* context) noexcept {
+            handler_ = handler;
+            context_ = context;
+        }
+        
+    protected:
+        void notifyComplete(uint8_t half) {
+            if (handler_) {
+                handler_(context_, half);
+            }
+        }
+        
+    private:
+        CompleteHandler handler_ = nullptr;
+        void* context_ = nullptr;
+    };
+    
+    /**
+     * @brief RP2350 DMA transport (PWM slice + two chained DMA channels)
+     *
+     * DMA is paced by a DMA timer at the sample rate, so the sample clock is
+     * hardware-generated and independent of interrupt latency.
+     */
+    class RP2DMATransport : public DMATransport {
+    private:
+        static RP2DMATransport* instance_;
+        
+        uint8_t pin_ = 255;                     // 255 until the PWM slice is set up
+        size_t block_frames_ = 0;
+        int dma_channels_[2] = {-1, -1};
+        int dma_timer_ = -1;
+        bool handler_installed_ = false;
+        
+    public:
+        bool begin(uint8_t pin, uint32_t sample_rate, size_t block_frames) override;
+        void start(const uint16_t* first, const uint16_t* second) override;
+        void queue(uint8_t half, const uint16_t* block) override;
+        void end() override;
+        
+        /**
+         * @brief Get singleton instance
+         * @return Reference to the singleton instance
+         */
+        static RP2DMATransport& getInstance();
+        
+    private:
+        static void dmaISR();
+        void handleDMAInterrupt();
+    };
+    
+    /**
+     * @brief Host stand-in for the DMA hardware
+     *
+     * Plays queued blocks one at a time when consumeBlock() is called, the
+     * same way the DMA engine would, so the output's buffer handling can be
+     * run and checked without a board.
+     */
+    class SimulatedDMATransport : public DMATransport {
+    private:
+        const uint16_t* queued_[2] = {nullptr, nullptr};
+        size_t block_frames_ = 0;
+        uint8_t playing_ = 0;
+        bool running_ = false;
+        
+    public:
+        bool begin(uint8_t, uint32_t, size_t block_frames) override {
+            block_frames_ = block_frames;
+            return true;
+        }
+        
+        void start(const uint16_t* first, const uint16_t* second) override {
+            queued_[0] = first;
+            queued_[1] = second;
+            playing_ = 0;
+            running_ = true;
+        }
+        
+        void queue(uint8_t half, const uint16_t* block) override {
+            queued_[half] = block;
+        }
+        
+        void end() override {
+            running_ = false;
+        }
+        
+        /**
+         * @brief Play the current block and raise its completion
+         * @param out Optional destination for the played PWM levels
+         * @return false if streaming is not running
+         */
+        bool consumeBlock(uint16_t* out = nullptr) {
+            if (!running_) {
+                return false;
+            }
+            const uint8_t half = playing_;
+            if (out != nullptr) {
+                std::copy(queued_[half], queued_[half] + block_frames_, out);
+            }
+            playing_ ^= 1;
+            notifyComplete(half);
+            return true;
+        }
+    };
+    
+    /**
+     * @brief DMA-fed PWM audio output
+     *
+     * Samples are rendered a block at a time, converted to 12-bit PWM levels
+     * and placed in a ring of blocks that the DMA transport streams into the
+     * PWM compare register. Only one interrupt is taken per block instead of
+     * one per sample. Mono: multi-channel blocks are averaged to one channel.
+     */
+    class DMAPWMAudioOutput : public AudioOutput {
+    public:
+        static constexpr size_t BLOCK_FRAMES = BLOCK_SIZE;
+        static constexpr size_t NUM_BLOCKS = KOEKIT_DMA_BLOCKS;
+        static_assert(NUM_BLOCKS >= 4, "KOEKIT_DMA_BLOCKS must be at least 4");
+        
+    private:
+        static inline DMAPWMAudioOutput* instance_ = nullptr;
+        
+        DMATransport* transport_ = nullptr;
+        
+        BlockRing<uint16_t, BLOCK_FRAMES, NUM_BLOCKS> ring_;
+        std::array<float, BLOCK_FRAMES * CHANNELS> scratch_ = {};
+        std::array<uint16_t, BLOCK_FRAMES> silence_ = {};
+        PWM::BlockConverter converter_;
+        bool half_owns_block_[2] = {false, false};  // Half is playing a ring block
+        
+        uint8_t output_pin_ = 1;
+        uint32_t sample_rate_ = SAMPLE_RATE;
+        volatile bool active_ = false;
+        volatile uint32_t underruns_ = 0;
+        
+    public:
+        /**
+         * @brief Use a specific DMA transport (call before begin())
+         * @param transport Transport to stream blocks through
+         */
+        void setTransport(DMATransport& transport) noexcept {
+            transport_ = &transport;
+        }
+        
+        /**
+         * @brief Set the PWM output pin (call before begin())
+         * @param pin PWM output pin
+         */
+        void setOutputPin(uint8_t pin) noexcept {
+            output_pin_ = pin;
+        }
+        
+        /**
+         * @brief Initialize DMA PWM audio output
+         * @param pin PWM output pin
+         * @param sample_rate Sample rate in Hz
+         * @return true if initialization successful
+         */
+        bool begin(uint8_t pin, uint32_t sample_rate) {
+            setOutputPin(pin);
+            return begin(sample_rate);
+        }
+        
+        /**
+         * @brief Initialize DMA PWM audio output on the configured pin
+         * @param sample_rate Sample rate in Hz
+         * @return true if initialization successful
+         */
+        bool begin(uint32_t sample_rate) override {
+            if (active_) {
+                end();
+            }
+
+#if defined(ARDUINO_ARCH_RP2040)
+            if (transport_ == nullptr) {
+                transport_ = &RP2DMATransport::getInstance();
+            }
+#endif
+            if (transport_ == nullptr) {
+                return false;
+            }
+            
+            sample_rate_ = sample_rate;
+            underruns_ = 0;
+            silence_.fill(PWM::CENTER);
+            ring_.reset();
+            converter_.reset();
+            
+            if (!transport_->begin(output_pin_, sample_rate, BLOCK_FRAMES)) {
+                return false;
+            }
+            transport_->setCompleteHandler(&DMAPWMAudioOutput::onBlockComplete, this);
+            
+            // Prime both DMA halves with the first two rendered blocks
+            fill();
+            const uint16_t* first = ring_.peekRead(0);
+            const uint16_t* second = ring_.peekRead(1);
+            half_owns_block_[0] = first != nullptr;
+            half_owns_block_[1] = second != nullptr;
+            active_ = true;
+            transport_->start(first ? first : silence_.data(), second ? second : silence_.data());
+            return true;
+        }
+        
+        /**
+         * @brief Stop audio output
+         */
+        void end() override {
+            if (active_ && transport_ != nullptr) {
+                transport_->end();
+            }
+            active_ = false;
+            clearSource();
+        }
+        
+        /**
+         * @brief Check if output is active
+         * @return true if audio output is running
+         */
+        bool isActive() const override { return active_; }
+        
+        /**
+         * @brief Get current sample rate
+         * @return Sample rate in Hz
+         */
+        uint32_t getSampleRate() const override { return sample_rate_; }
+        
+        /**
+         * @brief One DMA block per pull
+         */
+        size_t preferredBlockSize() const override { return BLOCK_FRAMES; }
+        
+        /**
+         * @brief Every block of the ring is rendered ahead of playback
+         */
+        uint32_t latencyFrames() const override { return NUM_BLOCKS * BLOCK_FRAMES; }
+        
+        /**
+         * @brief Get output pin
+         * @return PWM output pin number
+         */
+        uint8_t getOutputPin() const { return output_pin_; }
+        
+        /**
+         * @brief Block conversion settings (dither, DC blocker)
+         * @return Converter used for every rendered block
+         */
+        PWM::BlockConverter& getConverter() { return converter_; }
+        
+        /**
+         * @brief Number of blocks replaced by silence because none was ready
+         */
+        uint32_t getUnderrunCount() const override { return underruns_; }
+        
+        /**
+         * @brief Get singleton instance
+         * @return Reference to the singleton instance
+         */
+        static DMAPWMAudioOutput& getInstance() {
+            if (instance_ == nullptr) {
+                static DMAPWMAudioOutput instance;
+                instance_ = &instance;
+            }
+            return *instance_;
+        }
+        
+    private:
+        /**
+         * @brief Render and convert into every free block of the ring
+         *
+         * Without a source nothing is rendered: the ring drains and the
+         * halves fall back to silence, counted as underruns.
+         */
+        void fill() {
+            if (!hasSource()) {
+                return;
+            }
+            while (uint16_t* block = ring_.acquireWrite()) {
+                pull(scratch_.data(), BLOCK_FRAMES);
+                if (Detail::isSilent(scratch_.data(), scratch_.size()) &&
+                    converter_.fillSilence(block, BLOCK_FRAMES)) {
+                    ring_.commitWrite();
+                    continue;
+                }
+                if constexpr (CHANNELS > 1) {
+                    downmix();
+                }
+                countClip(converter_.convert(scratch_.data(), block, BLOCK_FRAMES));
+                ring_.commitWrite();
+            }
+        }
+        
+        /**
+         * @brief Average the interleaved channels of scratch_ into its first BLOCK_FRAMES samples
+         */
+        void downmix() {
+            constexpr float GAIN = 1.0f / CHANNELS;
+            for (size_t i = 0; i < BLOCK_FRAMES; ++i) {
+                float sum = 0.0f;
+                for (size_t c = 0; c < CHANNELS; ++c) {
+                    sum += scratch_[i * CHANNELS + c];
+                }
+                scratch_[i] = sum * GAIN;
+            }
+        }
+        
+        static void onBlockComplete(void* context, uint8_t half) {
+            static_cast<DMAPWMAudioOutput*>(context)->handleBlockComplete(half);
+        }
+        
+        /**
+         * @brief Refill the half that just finished (interrupt context)
+         * @param half DMA half that completed
+         */
+        void handleBlockComplete(uint8_t half) {
+            if (half_owns_block_[half]) {
+                ring_.releaseRead();
+            }
+            
+            fill();
+            
+            // The other half is still playing; skip its block if it owns one
+            const size_t next_offset = half_owns_block_[half ^ 1] ? 1 : 0;
+            const uint16_t* next = ring_.peekRead(next_offset);
+            if (next != nullptr) {
+                transport_->queue(half, next);
+                half_owns_block_[half] = true;
+            } else {
+                transport_->queue(half, silence_.data());
+                half_owns_block_[half] = false;
+                underruns_ = underruns_ + 1;
+            }
+        }
+    };
+
+} // namespace KoeKit
+
+#endif // KOEKIT_DMA_PWM_OUTPUT_H
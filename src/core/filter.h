@@ -184,6 +184,18 @@ namespace Filter {
          */
         float getNotch() const noexcept { return low_ + high_; }
         
+        /**
+         * @brief Check if the filter has rung out completely
+         * 
+         * Tiny states are flushed to zero, so after silent input every
+         * output reaches exactly 0.0 and stays there.
+         * 
+         * @return true if every output is exactly zero
+         */
+        bool isSilent() const noexcept {
+            return low_ == 0.0f && band_ == 0.0f && high_ == 0.0f;
+        }
+        
         /**
          * @brief Reset filter state
          */
@@ -360,6 +372,14 @@ namespace Filter {
             return output;
         }
         
+        /**
+         * @brief Check if silent input would give (almost) silent output
+         * @param threshold Largest remaining tail that counts as silence
+         */
+        bool isSilent(float threshold) const noexcept {
+            return x1_ == 0.0f && std::abs(y1_) < threshold;
+        }
+        
         /**
          * @brief Reset filter state
          */
@@ -0,0 +1,90 @@
+#pragma once
+
+/**
+ * @file inplace_function.h
+ * @brief Fixed-capacity, non-allocating callable wrapper
+ */
+
+#ifndef KOEKIT_INPLACE_FUNCTION_H
+#define KOEKIT_INPLACE_FUNCTION_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace KoeKit {
+    
+    template<typename Signature, size_t CAPACITY>
+    class InplaceFunction;
+    
+    /**
+     * @brief Callable stored inside the object, never on the heap
+     *
+     * Holds any trivially copyable callable up to CAPACITY bytes: function
+     * pointers, stateless lambdas and lambdas capturing pointers, references
+     * or small plain values. Calling it costs one indirect call, with no
+     * type-erased storage management. Oversized or non-trivial callables are
+     * rejected at compile time.
+     *
+     * @tparam R Return type
+     * @tparam Args Argument types
+     * @tparam CAPACITY Storage size in bytes
+     */
+    template<typename R, typename... Args, size_t CAPACITY>
+    class InplaceFunction<R(Args...), CAPACITY> {
+    private:
+        using Invoker = R (*)(void* storage, Args... args);
+        
+        alignas(alignof(std::max_align_t)) unsigned char storage_[CAPACITY] = {};
+        Invoker invoke_ = nullptr;
+        
+    public:
+        InplaceFunction() noexcept = default;
+        InplaceFunction(std::nullptr_t) noexcept {}
+        
+        /**
+         * @brief Store a callable
+         * @param callable Function pointer or lambda
+         */
+        template<typename F,
+                 typename Fn = std::decay_t<F>,
+                 typename = std::enable_if_t<!std::is_same_v<Fn, InplaceFunction> &&
+                                             std::is_invocable_r_v<R, Fn&, Args...>>>
+        InplaceFunction(F&& callable) noexcept {
+            static_assert(sizeof(Fn) <= CAPACITY,
+                          "Callable does not fit in InplaceFunction storage");
+            static_assert(alignof(Fn) <= alignof(std::max_align_t),
+                          "Callable alignment not supported");
+            static_assert(std::is_trivially_copyable_v<Fn>,
+                          "Callable must be trivially copyable (capture pointers or plain values)");
+            
+            ::new (static_cast<void*>(storage_)) Fn(std::forward<F>(callable));
+            invoke_ = [](void* storage, Args... args) -> R {
+                return (*std::launder(reinterpret_cast<Fn*>(storage)))(std::forward<Args>(args)...);
+            };
+        }
+        
+        InplaceFunction& operator=(std::nullptr_t) noexcept {
+            invoke_ = nullptr;
+            return *this;
+        }
+        
+        /**
+         * @brief Call the stored callable (must not be empty)
+         */
+        R operator()(Args... args) const {
+            return invoke_(const_cast<unsigned char*>(storage_), std::forward<Args>(args)...);
+        }
+        
+        /**
+         * @brief Check if a callable is stored
+         */
+        explicit operator bool() const noexcept {
+            return invoke_ != nullptr;
+        }
+    };
+
+} // namespace KoeKit
+
+#endif // KOEKIT_INPLACE_FUNCTION_H
@@ -0,0 +1,213 @@
+#pragma once
+
+/**
+ * @file load_governor.h
+ * @brief Overload protection by stepwise quality reduction for KoeKit
+ */
+
+#ifndef KOEKIT_LOAD_GOVERNOR_H
+#define KOEKIT_LOAD_GOVERNOR_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "inplace_function.h"
+
+#ifndef KOEKIT_MAX_LOAD_POLICIES
+#define KOEKIT_MAX_LOAD_POLICIES 4
+#endif
+
+#ifndef KOEKIT_CALLBACK_CAPACITY
+#define KOEKIT_CALLBACK_CAPACITY 16
+#endif
+
+namespace KoeKit {
+    
+    /**
+     * @brief Applies a degradation level on the audio thread
+     *
+     * Called with the policy's new level: 0 is full quality, higher levels
+     * are cheaper.
+     */
+    using LoadPolicyHandler = InplaceFunction<void(uint8_t), KOEKIT_CALLBACK_CAPACITY>;
+    
+    /**
+     * @brief Trades quality for render time when a patch overruns its budget
+     *
+     * Watches the time each block took against the real time it covers.
+     * When the smoothed load crosses the high threshold, or a block misses
+     * its deadline, the governor moves one step down a ladder built from
+     * the registered policies. The first policy registered is lowered
+     * first, one level at a time, until it is at its cheapest; then the
+     * next. After the load has stayed under the low threshold for the
+     * restore delay, quality comes back one step at a time, in reverse.
+     * Every step is followed by a short hold so its effect shows up in the
+     * measurements before the next decision.
+     *
+     * update() and the handlers run on the render context between blocks,
+     * so handlers may change any object the callback uses.
+     */
+    class LoadGovernor {
+    private:
+        static constexpr uint32_t HOLD_BLOCKS = 8;
+        static constexpr float SMOOTHING = 0.25f;
+        
+        struct Policy {
+            LoadPolicyHandler handler;
+            uint8_t levels = 0;
+            uint8_t level = 0;
+        };
+        
+        std::array<Policy, KOEKIT_MAX_LOAD_POLICIES> policies_ = {};
+        std::atomic<uint8_t> policy_count_{0};
+        
+        float high_ = 0.8f;
+        float low_ = 0.5f;
+        float restore_seconds_ = 1.0f;
+        uint32_t restore_blocks_ = 0;
+        
+        float load_ = 0.0f;             // Smoothed share of the budget used
+        uint32_t hold_ = 0;             // Blocks left before the next decision
+        uint32_t calm_ = 0;             // Consecutive blocks under the low threshold
+        std::atomic<uint8_t> level_{0};         // Steps down from full quality
+        std::atomic<uint32_t> degrades_{0};     // Steps down taken since begin()
+        
+        bool degrade(uint8_t count) {
+            for (uint8_t i = 0; i < count; ++i) {
+                Policy& policy = policies_[i];
+                if (policy.level < policy.levels) {
+                    policy.handler(++policy.level);
+                    return true;
+                }
+            }
+            return false;
+        }
+        
+        bool restore(uint8_t count) {
+            for (uint8_t i = count; i > 0; --i) {
+                Policy& policy = policies_[i - 1];
+                if (policy.level > 0) {
+                    policy.handler(--policy.level);
+                    return true;
+                }
+            }
+            return false;
+        }
+        
+    public:
+        /**
+         * @brief Register a policy (call from setup())
+         * @param handler Applies a level on the audio thread
+         * @param levels Number of cheaper levels below full quality
+         * @return false if KOEKIT_MAX_LOAD_POLICIES are in use
+         */
+        bool addPolicy(LoadPolicyHandler handler, uint8_t levels = 1) {
+            const uint8_t count = policy_count_.load(std::memory_order_relaxed);
+            if (count >= KOEKIT_MAX_LOAD_POLICIES || !handler || levels == 0) {
+                return false;
+            }
+            policies_[count].handler = handler;
+            policies_[count].levels = levels;
+            policies_[count].level = 0;
+            policy_count_.store(count + 1, std::memory_order_release);
+            return true;
+        }
+        
+        /**
+         * @brief Set the load thresholds (call before begin())
+         * @param high Share of the block budget that triggers a step down (0.0 to 1.0)
+         * @param low Share below which quality may come back
+         */
+        void setThresholds(float high, float low) {
+            high_ = high;
+            low_ = low < high ? low : high;
+        }
+        
+        /**
+         * @brief Set how long the load must stay low before a step back up
+         * @param seconds Restore delay (call before begin())
+         */
+        void setRestoreDelay(float seconds) {
+            restore_seconds_ = seconds;
+        }
+        
+        /**
+         * @brief Restore full quality and size the restore delay
+         * @param blocks_per_second Render blocks per second
+         */
+        void begin(float blocks_per_second) {
+            const uint8_t count = policy_count_.load(std::memory_order_acquire);
+            for (uint8_t i = 0; i < count; ++i) {
+                Policy& policy = policies_[i];
+                if (policy.level > 0) {
+                    policy.level = 0;
+                    policy.handler(0);
+                }
+            }
+            restore_blocks_ = static_cast<uint32_t>(restore_seconds_ * blocks_per_second) + 1;
+            load_ = 0.0f;
+            hold_ = 0;
+            calm_ = 0;
+            level_.store(0, std::memory_order_relaxed);
+            degrades_.store(0, std::memory_order_relaxed);
+        }
+        
+        /**
+         * @brief Account one block and step quality if needed (render context only)
+         * @param elapsed Ticks the block took
+         * @param budget Ticks of real time the block covers
+         */
+        void update(uint32_t elapsed, uint32_t budget) {
+            const uint8_t count = policy_count_.load(std::memory_order_acquire);
+            if (count == 0 || budget == 0) {
+                return;
+            }
+            
+            const float ratio = static_cast<float>(elapsed) / static_cast<float>(budget);
+            load_ += (ratio - load_) * SMOOTHING;
+            if (hold_ > 0) {
+                --hold_;
+                return;
+            }
+            
+            uint8_t level = level_.load(std::memory_order_relaxed);
+            if (load_ > high_ || ratio > 1.0f) {
+                calm_ = 0;
+                if (degrade(count)) {
+                    level_.store(level + 1, std::memory_order_relaxed);
+                    degrades_.store(degrades_.load(std::memory_order_relaxed) + 1,
+                                    std::memory_order_relaxed);
+                    hold_ = HOLD_BLOCKS;
+                }
+            } else if (load_ < low_ && level > 0) {
+                if (++calm_ >= restore_blocks_) {
+                    calm_ = 0;
+                    if (restore(count)) {
+                        level_.store(level - 1, std::memory_order_relaxed);
+                        hold_ = HOLD_BLOCKS;
+                    }
+                }
+            } else {
+                calm_ = 0;
+            }
+        }
+        
+        /**
+         * @brief Steps currently taken down from full quality
+         */
+        uint8_t getLevel() const {
+            return level_.load(std::memory_order_relaxed);
+        }
+        
+        /**
+         * @brief Steps down taken since begin()
+         */
+        uint32_t getDegradeCount() const {
+            return degrades_.load(std::memory_order_relaxed);
+        }
+    };
+
+} // namespace KoeKit
+
+#endif // KOEKIT_LOAD_GOVERNOR_H
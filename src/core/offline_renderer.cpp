@@ -0,0 +1,275 @@
+/**
+ * @file offline_renderer.cpp
+ * @brief Offline WAV rendering implementation for KoeKit (host builds only)
+ */
+
+#include "../KoeKit.h"
+
+#if !defined(ARDUINO)
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+namespace KoeKit {
+    
+    namespace {
+        
+        void putLE16(uint8_t* p, uint16_t value) {
+            p[0] = static_cast<uint8_t>(value);
+            p[1] = static_cast<uint8_t>(value >> 8);
+        }
+        
+        void putLE32(uint8_t* p, uint32_t value) {
+            for (int i = 0; i < 4; ++i) {
+                p[i] = static_cast<uint8_t>(value >> (8 * i));
+            }
+        }
+        
+        uint16_t getLE16(const uint8_t* p) {
+            return static_cast<uint16_t>(p[0] | (p[1] << 8));
+        }
+        
+        uint32_t getLE32(const uint8_t* p) {
+            return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+                   (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+        }
+    
+    } // namespace
+    
+    //=============================================================================
+    // WavFileWriter Implementation
+    //=============================================================================
+    
+    bool WavFileWriter::open(const char* path, uint32_t sample_rate, uint16_t channels) {
+        close();
+        
+        file_ = std::fopen(path, "wb");
+        if (file_ == nullptr) {
+            return false;
+        }
+        sample_rate_ = sample_rate;
+        channels_ = channels;
+        samples_written_ = 0;
+        buffer_pos_ = 0;
+        ok_ = writeHeader();
+        return ok_;
+    }
+    
+    bool WavFileWriter::write(const float* samples, size_t count) {
+        if (file_ == nullptr) {
+            return false;
+        }
+        while (count > 0) {
+            const size_t chunk = std::min(count, buffer_.size() - buffer_pos_);
+            for (size_t i = 0; i < chunk; ++i) {
+                const float s = std::clamp(samples[i], -1.0f, 1.0f);
+                buffer_[buffer_pos_ + i] = static_cast<int16_t>(std::lrintf(s * 32767.0f));
+            }
+            buffer_pos_ += chunk;
+            samples += chunk;
+            count -= chunk;
+            samples_written_ += static_cast<uint32_t>(chunk);
+            
+            if (buffer_pos_ == buffer_.size() && !flush()) {
+                return false;
+            }
+        }
+        return ok_;
+    }
+    
+    bool WavFileWriter::close() {
+        if (file_ == nullptr) {
+            return ok_;
+        }
+        flush();
+        
+        // Patch the chunk sizes now that the length is known
+        if (std::fseek(file_, 0, SEEK_SET) != 0 || !writeHeader()) {
+            ok_ = false;
+        }
+        if (std::fclose(file_) != 0) {
+            ok_ = false;
+        }
+        file_ = nullptr;
+        return ok_;
+    }
+    
+    bool WavFileWriter::flush() {
+        if (buffer_pos_ > 0) {
+            if (std::fwrite(buffer_.data(), sizeof(int16_t), buffer_pos_, file_) != buffer_pos_) {
+                ok_ = false;
+            }
+            buffer_pos_ = 0;
+        }
+        return ok_;
+    }
+    
+    bool WavFileWriter::writeHeader() {
+        const uint32_t data_bytes = samples_written_ * sizeof(int16_t);
+        const uint16_t block_align = channels_ * sizeof(int16_t);
+        
+        uint8_t header[44];
+        std::memcpy(header + 0, "RIFF", 4);
+        putLE32(header + 4, 36 + data_bytes);
+        std::memcpy(header + 8, "WAVE", 4);
+        std::memcpy(header + 12, "fmt ", 4);
+        putLE32(header + 16, 16);                          // fmt chunk size
+        putLE16(header + 20, 1);                           // PCM
+        putLE16(header + 22, channels_);
+        putLE32(header + 24, sample_rate_);
+        putLE32(header + 28, sample_rate_ * block_align);  // Byte rate
+        putLE16(header + 32, block_align);
+        putLE16(header + 34, 16);                          // Bits per sample
+        std::memcpy(header + 36, "data", 4);
+        putLE32(header + 40, data_bytes);
+        
+        return std::fwrite(header, 1, sizeof(header), file_) == sizeof(header);
+    }
+    
+    //=============================================================================
+    // WavFileReader Implementation
+    //=============================================================================
+    
+    bool WavFileReader::open(const char* path) {
+        close();
+        
+        file_ = std::fopen(path, "rb");
+        if (file_ == nullptr) {
+            return false;
+        }
+        uint8_t riff[12];
+        if (std::fread(riff, 1, sizeof(riff), file_) != sizeof(riff) ||
+            std::memcmp(riff, "RIFF", 4) != 0 || std::memcmp(riff + 8, "WAVE", 4) != 0) {
+            close();
+            return false;
+        }
+        
+        // Walk the chunks: "fmt " describes the samples, "data" holds them
+        uint16_t format = 0;
+        uint8_t chunk[8];
+        while (std::fread(chunk, 1, sizeof(chunk), file_) == sizeof(chunk)) {
+            const uint32_t size = getLE32(chunk + 4);
+            if (std::memcmp(chunk, "fmt ", 4) == 0 && size >= 16) {
+                uint8_t fmt[16];
+                if (std::fread(fmt, 1, sizeof(fmt), file_) != sizeof(fmt)) {
+                    break;
+                }
+                format = getLE16(fmt);
+                channels_ = getLE16(fmt + 2);
+                sample_rate_ = getLE32(fmt + 4);
+                bits_ = getLE16(fmt + 14);
+                std::fseek(file_, static_cast<long>(size - 16 + (size & 1)), SEEK_CUR);
+            } else if (std::memcmp(chunk, "data", 4) == 0) {
+                const bool pcm16 = format == 1 && bits_ == 16;
+                const bool float32 = format == 3 && bits_ == 32;
+                if ((!pcm16 && !float32) || channels_ == 0) {
+                    break;
+                }
+                data_offset_ = std::ftell(file_);
+                data_frames_ = size / (channels_ * (bits_ / 8));
+                frames_left_ = data_frames_;
+                return true;
+            } else {
+                std::fseek(file_, static_cast<long>(size + (size & 1)), SEEK_CUR);
+            }
+        }
+        close();
+        return false;
+    }
+    
+    size_t WavFileReader::read(float* out, size_t frames) {
+        if (file_ == nullptr) {
+            return 0;
+        }
+        frames = std::min(frames, static_cast<size_t>(frames_left_));
+        const size_t bytes = bits_ / 8;
+        uint8_t sample[4];
+        for (size_t i = 0; i < frames; ++i) {
+            float last = 0.0f;
+            for (size_t c = 0; c < channels_; ++c) {
+                if (std::fread(sample, 1, bytes, file_) != bytes) {
+                    frames_left_ = 0;
+                    return i;
+                }
+                if (bits_ == 16) {
+                    last = static_cast<int16_t>(getLE16(sample)) * (1.0f / 32768.0f);
+                } else {
+                    const uint32_t bits = getLE32(sample);
+                    std::memcpy(&last, &bits, sizeof(last));
+                }
+                if (c < CHANNELS) {
+                    out[i * CHANNELS + c] = last;
+                }
+            }
+            for (size_t c = channels_; c < CHANNELS; ++c) {
+                out[i * CHANNELS + c] = last;
+            }
+        }
+        frames_left_ -= static_cast<uint32_t>(frames);
+        return frames;
+    }
+    
+    bool WavFileReader::rewind() {
+        if (file_ == nullptr || std::fseek(file_, data_offset_, SEEK_SET) != 0) {
+            return false;
+        }
+        frames_left_ = data_frames_;
+        return data_frames_ > 0;
+    }
+    
+    void WavFileReader::close() {
+        if (file_ != nullptr) {
+            std::fclose(file_);
+            file_ = nullptr;
+        }
+        frames_left_ = 0;
+    }
+    
+    //=============================================================================
+    // OfflineRenderer Implementation
+    //=============================================================================
+    
+    OfflineRenderer::Result OfflineRenderer::renderToWav(const char* path, float seconds,
+                                                         uint32_t sample_rate) {
+        const uint32_t frames = static_cast<uint32_t>(std::lround(seconds * sample_rate));
+        return renderFramesToWav(path, frames, sample_rate);
+    }
+    
+    OfflineRenderer::Result OfflineRenderer::renderFramesToWav(const char* path, uint32_t frames,
+                                                               uint32_t sample_rate) {
+        Result result;
+        
+        // Run the engine on the file as on any output, so the render rate,
+        // oversampling, input and render statistics are set up as in real time
+        AudioEngine& engine = AudioEngine::getInstance();
+        if (engine.initialized_) {
+            engine.stop();
+        }
+        FileAudioOutput file(path);
+        if (!engine.begin(file, sample_rate)) {
+            return result;
+        }
+        
+        const auto start = std::chrono::steady_clock::now();
+        bool ok = file.pump(frames);
+        ok = file.close() && ok;
+        const auto stop = std::chrono::steady_clock::now();
+        
+        // Keep the patch, so the same sketch can be rendered again
+        engine.stop();
+        
+        result.ok = ok;
+        result.frames = ok ? frames : 0;
+        result.wall_seconds = std::chrono::duration<double>(stop - start).count();
+        if (result.wall_seconds > 0.0) {
+            result.realtime_factor = (static_cast<double>(result.frames) / sample_rate) /
+                                     result.wall_seconds;
+        }
+        return result;
+    }
+
+} // namespace KoeKit
+
+#endif // !ARDUINO
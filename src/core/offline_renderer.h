@@ -0,0 +1,304 @@
+#pragma once
+
+/**
+ * @file offline_renderer.h
+ * @brief WAV file input/output and faster-than-real-time rendering (host builds only)
+ */
+
+#ifndef KOEKIT_OFFLINE_RENDERER_H
+#define KOEKIT_OFFLINE_RENDERER_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include "audio_backend.h"
+#include "audio_input.h"
+
+#ifndef KOEKIT_WAV_BUFFER_SAMPLES
+#define KOEKIT_WAV_BUFFER_SAMPLES 8192
+#endif
+
+namespace KoeKit {
+    
+    /**
+     * @brief 16-bit PCM WAV file writer with buffered output
+     *
+     * Samples are converted into a fixed buffer and written in large chunks.
+     * The header sizes are patched in when the file is closed.
+     */
+    class WavFileWriter {
+    private:
+        FILE* file_ = nullptr;
+        uint32_t sample_rate_ = 0;
+        uint16_t channels_ = 1;
+        uint32_t samples_written_ = 0;
+        size_t buffer_pos_ = 0;
+        bool ok_ = false;
+        std::array<int16_t, KOEKIT_WAV_BUFFER_SAMPLES> buffer_ = {};
+        
+    public:
+        WavFileWriter() = default;
+        WavFileWriter(const WavFileWriter&) = delete;
+        WavFileWriter& operator=(const WavFileWriter&) = delete;
+        ~WavFileWriter() { close(); }
+        
+        /**
+         * @brief Create the file and write a placeholder header
+         * @param path Output file path
+         * @param sample_rate Sample rate in Hz
+         * @param channels Interleaved channel count
+         * @return true if the file could be created
+         */
+        bool open(const char* path, uint32_t sample_rate, uint16_t channels = 1);
+        
+        /**
+         * @brief Append float samples (-1.0 to 1.0, clipped)
+         * @param samples Interleaved samples
+         * @param count Number of samples (frames * channels)
+         * @return false if a write failed
+         */
+        bool write(const float* samples, size_t count);
+        
+        /**
+         * @brief Flush, patch the header and close the file
+         * @return false if any write failed
+         */
+        bool close();
+        
+        /**
+         * @brief Check if a file is open
+         */
+        bool isOpen() const { return file_ != nullptr; }
+        
+        /**
+         * @brief Number of samples written so far
+         */
+        uint32_t getSamplesWritten() const { return samples_written_; }
+        
+    private:
+        bool flush();
+        bool writeHeader();
+    };
+    
+    /**
+     * @brief 16-bit PCM or 32-bit float WAV file reader
+     *
+     * Reads interleaved frames and maps the file's channels onto CHANNELS:
+     * extra channels are dropped, missing ones repeat the last channel.
+     */
+    class WavFileReader {
+    private:
+        FILE* file_ = nullptr;
+        uint32_t sample_rate_ = 0;
+        uint16_t channels_ = 0;
+        uint16_t bits_ = 0;
+        long data_offset_ = 0;          // File position of the first frame
+        uint32_t data_frames_ = 0;
+        uint32_t frames_left_ = 0;
+        
+    public:
+        WavFileReader() = default;
+        WavFileReader(const WavFileReader&) = delete;
+        WavFileReader& operator=(const WavFileReader&) = delete;
+        ~WavFileReader() { close(); }
+        
+        /**
+         * @brief Open a file and find its sample data
+         * @param path Input file path
+         * @return false if the file is missing or not a supported WAV file
+         */
+        bool open(const char* path);
+        
+        /**
+         * @brief Read frames as CHANNELS interleaved floats
+         * @param out Destination (frames * CHANNELS samples)
+         * @param frames Frames wanted
+         * @return Frames read; fewer at the end of the file
+         */
+        size_t read(float* out, size_t frames);
+        
+        /**
+         * @brief Go back to the first frame
+         * @return false if the file could not be rewound
+         */
+        bool rewind();
+        
+        /**
+         * @brief Close the file
+         */
+        void close();
+        
+        bool isOpen() const { return file_ != nullptr; }
+        uint32_t getSampleRate() const { return sample_rate_; }
+        uint16_t getChannels() const { return channels_; }
+    };
+    
+    /**
+     * @brief Input that plays a WAV file into the process callback
+     *
+     * Host stand-in for ADCAudioInput: nothing clocks it, so a block is
+     * read from the file whenever the engine asks for one and none is
+     * waiting. After the end of the file it captures silence, or starts
+     * over with setLoop(true). The file is read at the engine's rate
+     * whatever rate it was recorded at.
+     */
+    class FileAudioInput : public AudioInput {
+    private:
+        const char* path_ = nullptr;
+        WavFileReader reader_;
+        uint32_t sample_rate_ = 0;
+        bool loop_ = false;
+        bool finished_ = false;
+        
+    public:
+        /**
+         * @param path Input file path (kept, not copied)
+         */
+        explicit FileAudioInput(const char* path) : path_(path) {}
+        
+        /**
+         * @brief Start over at the end of the file (call before begin())
+         * @param loop true to loop
+         */
+        void setLoop(bool loop) { loop_ = loop; }
+        
+        bool begin(uint32_t sample_rate) override {
+            sample_rate_ = sample_rate;
+            finished_ = false;
+            resetCapture();
+            return reader_.open(path_);
+        }
+        
+        void end() override { reader_.close(); }
+        bool isActive() const override { return reader_.isOpen(); }
+        uint32_t getSampleRate() const override { return sample_rate_; }
+        
+        /**
+         * @brief Check if every frame of the file has been captured
+         */
+        bool isFinished() const { return finished_; }
+        
+    protected:
+        void poll() override {
+            float* block = acquireCapture();
+            if (block == nullptr) {
+                return;
+            }
+            size_t frames = reader_.read(block, BLOCK_SIZE);
+            if (frames < BLOCK_SIZE && loop_ && reader_.rewind()) {
+                frames += reader_.read(block + frames * CHANNELS, BLOCK_SIZE - frames);
+            }
+            if (frames < BLOCK_SIZE) {
+                finished_ = true;
+                std::fill(block + frames * CHANNELS, block + BLOCK_SAMPLES, 0.0f);
+            }
+            commitCapture();
+        }
+    };
+    
+    /**
+     * @brief Output that writes audio to a WAV file
+     *
+     * Nothing drives it: call pump() to render a number of frames, as fast
+     * as the host allows. 16-bit, CHANNELS interleaved channels.
+     */
+    class FileAudioOutput : public AudioOutput {
+    public:
+        static constexpr size_t BLOCK_FRAMES = 1024;
+        
+    private:
+        const char* path_ = nullptr;
+        WavFileWriter writer_;
+        std::array<float, BLOCK_FRAMES * CHANNELS> block_ = {};
+        uint32_t sample_rate_ = 0;
+        
+    public:
+        /**
+         * @param path Output file path (kept, not copied)
+         */
+        explicit FileAudioOutput(const char* path) : path_(path) {}
+        
+        bool begin(uint32_t sample_rate) override {
+            sample_rate_ = sample_rate;
+            return writer_.open(path_, sample_rate, CHANNELS);
+        }
+        
+        void end() override {
+            writer_.close();
+            clearSource();
+        }
+        
+        bool isActive() const override { return writer_.isOpen(); }
+        uint32_t getSampleRate() const override { return sample_rate_; }
+        size_t preferredBlockSize() const override { return BLOCK_FRAMES; }
+        uint32_t latencyFrames() const override { return 0; }
+        
+        /**
+         * @brief Render audio into the file
+         * @param frames Number of frames to render
+         * @return false if the file is not open or a write failed
+         */
+        bool pump(size_t frames) {
+            bool ok = writer_.isOpen();
+            while (ok && frames > 0) {
+                const size_t n = std::min(frames, BLOCK_FRAMES);
+                pull(block_.data(), n);
+                ok = writer_.write(block_.data(), n * CHANNELS);
+                frames -= n;
+            }
+            return ok;
+        }
+        
+        /**
+         * @brief Flush and close the file
+         * @return false if any write failed
+         */
+        bool close() { return writer_.close(); }
+    };
+    
+    /**
+     * @brief Renders the active audio callback to a WAV file
+     *
+     * Starts the engine on a FileAudioOutput and pumps it in a tight loop,
+     * with no interrupt, as fast as the host allows. The internal rate,
+     * oversampling, input and render statistics behave as in real time;
+     * the engine is stopped afterwards but keeps its callback. Set the
+     * callback first with setAudioCallback() or setBlockCallback().
+     */
+    class OfflineRenderer {
+    public:
+        /**
+         * @brief Outcome of a render
+         */
+        struct Result {
+            bool ok = false;             ///< File written completely
+            uint32_t frames = 0;         ///< Frames rendered
+            double wall_seconds = 0.0;   ///< Host time spent rendering
+            double realtime_factor = 0.0;///< Audio seconds per wall second
+        };
+        
+        /**
+         * @brief Render a number of seconds of audio to a WAV file
+         * @param path Output file path
+         * @param seconds Length of the render
+         * @param sample_rate Sample rate in Hz
+         * @return Render result and timing
+         */
+        static Result renderToWav(const char* path, float seconds,
+                                  uint32_t sample_rate = SAMPLE_RATE);
+        
+        /**
+         * @brief Render a number of frames to a WAV file
+         * @param path Output file path
+         * @param frames Frames to render
+         * @param sample_rate Sample rate in Hz
+         * @return Render result and timing
+         */
+        static Result renderFramesToWav(const char* path, uint32_t frames,
+                                        uint32_t sample_rate = SAMPLE_RATE);
+    };
+
+} // namespace KoeKit
+
+#endif // KOEKIT_OFFLINE_RENDERER_H
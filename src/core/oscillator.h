@@ -16,22 +16,34 @@ namespace KoeKit {
     /**
      * @brief Phase accumulator for oscillators
      * 
-     * Provides precise phase tracking with frequency control.
-     * Uses double precision for phase to minimize drift.
+     * The phase is a 32-bit fixed-point fraction of a cycle (2^32 = one
+     * cycle), so wrapping is free through unsigned overflow and the phase
+     * never drifts. Frequency resolution is sample_rate / 2^32 (about
+     * 5 uHz at 22050 Hz).
      */
     class PhaseAccumulator {
     private:
-        double phase_ = 0.0;
-        double increment_ = 0.0;
+        static constexpr double CYCLE = 4294967296.0;   // 2^32
+        
+        uint32_t phase_ = 0;
+        uint32_t increment_ = 0;
         float sample_rate_ = SAMPLE_RATE_F;
         
+        /**
+         * @brief Fraction of a cycle to fixed point (wraps any value)
+         */
+        static uint32_t toFixed(double cycles) noexcept {
+            cycles -= std::floor(cycles);
+            return static_cast<uint32_t>(static_cast<uint64_t>(cycles * CYCLE));
+        }
+        
     public:
         /**
          * @brief Set oscillator frequency
          * @param frequency Frequency in Hz
          */
         void setFrequency(float frequency) noexcept {
-            increment_ = static_cast<double>(frequency) / sample_rate_;
+            increment_ = toFixed(static_cast<double>(frequency) / sample_rate_);
         }
         
         /**
@@ -49,7 +61,15 @@ namespace KoeKit {
          * @return Frequency in Hz
          */
         float getCurrentFrequency() const noexcept {
-            return static_cast<float>(increment_ * sample_rate_);
+            return static_cast<float>(increment_ / CYCLE * sample_rate_);
+        }
+        
+        /**
+         * @brief Get the phase increment in fixed point
+         * @return Cycles per sample, 2^32 = one cycle
+         */
+        uint32_t getIncrement() const noexcept {
+            return increment_;
         }
         
         /**
@@ -58,27 +78,31 @@ namespace KoeKit {
          */
         float tick() noexcept {
             phase_ += increment_;
-            if (phase_ >= 1.0) {
-                phase_ -= 1.0;
-            }
-            return static_cast<float>(phase_);
+            return getPhase();
+        }
+        
+        /**
+         * @brief Advance phase and get it in fixed point
+         * @return Phase (0 to 2^32 - 1 for one cycle)
+         */
+        uint32_t tickFixed() noexcept {
+            phase_ += increment_;
+            return phase_;
         }
         
         /**
          * @brief Reset phase to zero
          */
         void reset() noexcept {
-            phase_ = 0.0;
+            phase_ = 0;
         }
         
         /**
          * @brief Set phase directly
-         * @param phase Phase value (0.0 to 1.0)
+         * @param phase Phase value (wrapped to 0.0 to 1.0)
          */
         void setPhase(float phase) noexcept {
-            phase_ = static_cast<double>(phase);
-            while (phase_ >= 1.0) phase_ -= 1.0;
-            while (phase_ < 0.0) phase_ += 1.0;
+            phase_ = toFixed(static_cast<double>(phase));
         }
         
         /**
@@ -86,29 +110,44 @@ namespace KoeKit {
          * @return Current phase (0.0 to 1.0)
          */
         float getPhase() const noexcept {
-            return static_cast<float>(phase_);
+            // Float rounding can reach 1.0 just below the wrap
+            return std::min(static_cast<float>(phase_ / CYCLE), 0x1.fffffep-1f);
         }
     };
     
+    /**
+     * @brief Wavetable lookup mode
+     */
+    enum class Interpolation : uint8_t {
+        NEAREST,    ///< Truncate to the sample below (cheapest, most aliasing)
+        LINEAR,     ///< Linear between neighbouring samples (default)
+        CUBIC       ///< 4-point Hermite (smoothest, about twice the cost of LINEAR)
+    };
+    
     /**
      * @brief Wavetable oscillator
      * 
-     * High-quality oscillator using wavetable lookup with linear interpolation.
-     * Template parameter allows compile-time optimization for specific table sizes.
+     * High-quality oscillator using wavetable lookup with linear interpolation by default.
+     * Template parameters allow compile-time optimization for specific table sizes
+     * and sample storage (see Q15Storage, FloatStorage, Int8Storage).
      */
-    template<size_t TABLE_SIZE>
+    template<size_t TABLE_SIZE, typename Storage = Q15Storage>
     class WavetableOscillator {
+    public:
+        using Table = Wavetable<TABLE_SIZE, Storage>;
+        
     private:
         PhaseAccumulator phase_;
-        const Wavetable<TABLE_SIZE>* wavetable_;
+        const Table* wavetable_;
         float amplitude_ = 1.0f;
+        Interpolation interpolation_ = Interpolation::LINEAR;
         
     public:
         /**
          * @brief Construct oscillator with wavetable
          * @param wavetable Reference to wavetable
          */
-        explicit WavetableOscillator(const Wavetable<TABLE_SIZE>& wavetable) 
+        explicit WavetableOscillator(const Table& wavetable) 
             : wavetable_(&wavetable) {}
         
         /**
@@ -139,18 +178,58 @@ namespace KoeKit {
          * @brief Change wavetable
          * @param wavetable Reference to new wavetable
          */
-        void setWavetable(const Wavetable<TABLE_SIZE>& wavetable) noexcept {
+        void setWavetable(const Table& wavetable) noexcept {
             wavetable_ = &wavetable;
         }
         
+        /**
+         * @brief Choose the table lookup (e.g. NEAREST to save cycles under load)
+         * @param interpolation Lookup mode
+         */
+        void setInterpolation(Interpolation interpolation) noexcept {
+            interpolation_ = interpolation;
+        }
+        
+        /**
+         * @brief Get the table lookup mode
+         * @return Lookup mode
+         */
+        Interpolation getInterpolation() const noexcept {
+            return interpolation_;
+        }
+        
         /**
          * @brief Process one sample
+         * 
+         * Power-of-two tables are indexed straight from the fixed-point
+         * phase; other sizes go through the float index.
+         * 
          * @return Output sample (-1.0 to 1.0)
          */
         float process() noexcept {
-            const float phase = phase_.tick();
-            const float table_index = phase * TABLE_SIZE;
-            return wavetable_->getInterpolated(table_index) * amplitude_;
+            if constexpr (Table::POWER_OF_TWO) {
+                const uint32_t phase = phase_.tickFixed();
+                switch (interpolation_) {
+                    case Interpolation::NEAREST:
+                        return wavetable_->lookupNearest(phase) * amplitude_;
+                    case Interpolation::CUBIC:
+                        return wavetable_->lookupCubic(phase) * amplitude_;
+                    default:
+                        return wavetable_->lookupLinear(phase) * amplitude_;
+                }
+            } else {
+                const float phase = phase_.tick();
+                const float table_index = phase * TABLE_SIZE;
+                switch (interpolation_) {
+                    case Interpolation::NEAREST:
+                        return static_cast<float>(wavetable_->getSample(static_cast<size_t>(table_index))) *
+                               (amplitude_ / Storage::SCALE);
+                    case Interpolation::CUBIC:
+                        return wavetable_->getCubic(table_index) * amplitude_;
+                    default:
+                        return wavetable_->getInterpolated(table_index) * amplitude_;
+                }
+            }
         }
         
         /**
@@ -190,6 +269,169 @@ namespace KoeKit {
      */
     using Oscillator = WavetableOscillator<WAVETABLE_SIZE>;
     
+    /**
+     * @brief Oscillator for quarter-wave compressed tables (e.g. Basic::SINE_COMPACT)
+     */
+    using QuarterWaveOscillator = WavetableOscillator<WAVETABLE_SIZE, QuarterWaveStorage<>>;
+    
+    /**
+     * @brief Oscillator for half-wave compressed tables (e.g. Basic::SQUARE_COMPACT)
+     */
+    using HalfWaveOscillator = WavetableOscillator<WAVETABLE_SIZE, HalfWaveStorage<>>;
+    
+    /**
+     * @brief Band-limited oscillator over a mipmapped wavetable
+     * 
+     * Plays a MipmapWavetable (see wavetables/bandlimited.h), choosing
+     * the level from the phase increment whenever the frequency or sample
+     * rate changes, and crossfading into the next level over each octave
+     * so sweeps change timbre smoothly. No harmonic passes Nyquist at any
+     * frequency, so saw and square stay clean without oversampling; each
+     * sample costs two table lookups while a crossfade is under way.
+     * 
+     * @tparam TABLE_SIZE Samples per level
+     * @tparam Storage Sample storage policy of the levels
+     */
+    template<size_t TABLE_SIZE, typename Storage = Q15Storage>
+    class MipmapOscillator {
+    public:
+        using Table = MipmapWavetable<TABLE_SIZE, Storage>;
+        
+    private:
+        PhaseAccumulator phase_;
+        const Table* table_;
+        MipSelection mip_;
+        float amplitude_ = 1.0f;
+        Interpolation interpolation_ = Interpolation::LINEAR;
+        
+        float lookup(const typename Table::Level& level, uint32_t phase) const noexcept {
+            switch (interpolation_) {
+                case Interpolation::NEAREST:
+                    return level.lookupNearest(phase);
+                case Interpolation::CUBIC:
+                    return level.lookupCubic(phase);
+                default:
+                    return level.lookupLinear(phase);
+            }
+        }
+        
+    public:
+        /**
+         * @brief Construct oscillator with mipmapped wavetable
+         * @param table Reference to mipmapped wavetable
+         */
+        explicit MipmapOscillator(const Table& table)
+            : table_(&table), mip_(Table::select(0)) {}
+        
+        /**
+         * @brief Set oscillator frequency (and pick the mip levels)
+         * @param frequency Frequency in Hz
+         */
+        void setFrequency(float frequency) noexcept {
+            phase_.setFrequency(frequency);
+            mip_ = Table::select(phase_.getIncrement());
+        }
+        
+        /**
+         * @brief Set oscillator amplitude
+         * @param amplitude Amplitude (0.0 to 1.0)
+         */
+        void setAmplitude(float amplitude) noexcept {
+            amplitude_ = std::clamp(amplitude, 0.0f, 1.0f);
+        }
+        
+        /**
+         * @brief Set phase offset
+         * @param phase Phase (0.0 to 1.0)
+         */
+        void setPhase(float phase) noexcept {
+            phase_.setPhase(phase);
+        }
+        
+        /**
+         * @brief Change mipmapped wavetable
+         * @param table Reference to new mipmapped wavetable
+         */
+        void setWavetable(const Table& table) noexcept {
+            table_ = &table;
+        }
+        
+        /**
+         * @brief Choose the table lookup within each level
+         * @param interpolation Lookup mode
+         */
+        void setInterpolation(Interpolation interpolation) noexcept {
+            interpolation_ = interpolation;
+        }
+        
+        /**
+         * @brief Get the table lookup mode
+         * @return Lookup mode
+         */
+        Interpolation getInterpolation() const noexcept {
+            return interpolation_;
+        }
+        
+        /**
+         * @brief Get the levels currently playing
+         * @return Mip level and crossfade amount
+         */
+        MipSelection getMipSelection() const noexcept {
+            return mip_;
+        }
+        
+        /**
+         * @brief Process one sample
+         * @return Output sample (-1.0 to 1.0)
+         */
+        float process() noexcept {
+            const uint32_t phase = phase_.tickFixed();
+            const float a = lookup(table_->getLevel(mip_.level), phase);
+            if (mip_.blend <= 0.0f) {
+                return a * amplitude_;
+            }
+            const float b = lookup(table_->getLevel(mip_.level + 1), phase);
+            return (a + mip_.blend * (b - a)) * amplitude_;
+        }
+        
+        /**
+         * @brief Reset oscillator state
+         */
+        void reset() noexcept {
+            phase_.reset();
+        }
+        
+        /**
+         * @brief Set sample rate
+         * @param sample_rate Sample rate in Hz
+         */
+        void setSampleRate(float sample_rate) noexcept {
+            phase_.setSampleRate(sample_rate);
+            mip_ = Table::select(phase_.getIncrement());
+        }
+        
+        /**
+         * @brief Get current frequency
+         * @return Frequency in Hz
+         */
+        float getFrequency() const noexcept {
+            return phase_.getCurrentFrequency();
+        }
+        
+        /**
+         * @brief Get current amplitude
+         * @return Amplitude (0.0 to 1.0)
+         */
+        float getAmplitude() const noexcept {
+            return amplitude_;
+        }
+    };
+    
+    /**
+     * @brief Convenient type alias for the standard band-limited oscillator
+     */
+    using BandLimitedOscillator = MipmapOscillator<WAVETABLE_SIZE>;
+    
     /**
      * @brief Simple noise generator
      * 
@@ -260,7 +502,7 @@ namespace KoeKit {
     inline Oscillator createOscillator(Wavetables::Basic::Waveform waveform) {
         return Oscillator(Wavetables::Basic::getWavetable(waveform));
     }
-    
+
 } // namespace KoeKit
 
 #endif // KOEKIT_OSCILLATOR_H
\ No newline at end of file
@@ -0,0 +1,302 @@
+#pragma once
+
+/**
+ * @file param_queue.h
+ * @brief Parameter and event messages from loop() to the audio thread
+ */
+
+#ifndef KOEKIT_PARAM_QUEUE_H
+#define KOEKIT_PARAM_QUEUE_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "inplace_function.h"
+#include "spsc_queue.h"
+
+#ifndef KOEKIT_MAX_PARAMS
+#define KOEKIT_MAX_PARAMS 16
+#endif
+
+#ifndef KOEKIT_PARAM_QUEUE_SIZE
+#define KOEKIT_PARAM_QUEUE_SIZE 64
+#endif
+
+#ifndef KOEKIT_SCHEDULE_SIZE
+#define KOEKIT_SCHEDULE_SIZE 32
+#endif
+
+#ifndef KOEKIT_CALLBACK_CAPACITY
+#define KOEKIT_CALLBACK_CAPACITY 16
+#endif
+
+namespace KoeKit {
+    
+    /**
+     * @brief Applies a parameter value or handles an event on the audio thread
+     */
+    using ParamHandler = InplaceFunction<void(float), KOEKIT_CALLBACK_CAPACITY>;
+    
+    /**
+     * @brief Identifies a registered parameter or event
+     */
+    using ParamId = uint8_t;
+    
+    constexpr ParamId INVALID_PARAM = 0xFF;
+    
+    /**
+     * @brief Wait-free parameter/event channel into the audio thread
+     *
+     * Register handlers in setup(), then post values from loop() (one
+     * producer context). The engine drains the queue at the start of every
+     * block, so handlers run on the audio thread between blocks and never
+     * race with the objects the callback is using.
+     *
+     * Parameters coalesce on the producer side: set() stores the value in
+     * the parameter's slot and only queues the id if it is not already
+     * waiting, so the last write always wins, the handler runs once per
+     * block at most, and a fast pot sweep can never fill the queue. Events
+     * are queued with their value and each one runs its handler in order.
+     * A parameter is applied at the position where its id was queued, with
+     * its latest value, so an event always sees values set before it.
+     *
+     * schedule() stamps a message with a render frame instead. Stamped
+     * messages wait in a sorted list (KOEKIT_SCHEDULE_SIZE entries) and the
+     * engine splits its block so that each one is applied right before the
+     * frame it names is rendered. Frames wrap; only stamps within 2^31
+     * frames of the current time are meaningful.
+     */
+    class ParamQueue {
+    public:
+        /**
+         * @brief One queued update
+         */
+        struct Message {
+            ParamId id = INVALID_PARAM;
+            bool timed = false;     ///< Apply at `frame` rather than at the next block
+            float value = 0.0f;     ///< Event argument (untimed parameters use their slot)
+            uint32_t frame = 0;     ///< Render frame for timed messages
+        };
+        
+    private:
+        struct Slot {
+            ParamHandler handler;
+            bool is_event = false;
+            std::atomic<float> value{0.0f};     // Latest parameter value
+            uint32_t queued = 0;                // Ids queued (producer only)
+            std::atomic<uint32_t> taken{0};     // Ids popped (consumer only)
+        };
+        
+        std::array<Slot, KOEKIT_MAX_PARAMS> slots_ = {};
+        std::atomic<uint8_t> slot_count_{0};
+        SPSCQueue<Message, KOEKIT_PARAM_QUEUE_SIZE> queue_;
+        
+        // Timed messages, latest first, so the next one due is at the back
+        std::array<Message, KOEKIT_SCHEDULE_SIZE> scheduled_ = {};
+        size_t scheduled_count_ = 0;
+        std::atomic<uint32_t> schedule_dropped_{0};     // Consumer only
+        std::atomic<uint32_t> late_{0};                 // Consumer only
+        
+        static int32_t until(uint32_t frame, uint32_t now) {
+            return static_cast<int32_t>(frame - now);
+        }
+        
+        static void bump(std::atomic<uint32_t>& counter) {
+            counter.store(counter.load(std::memory_order_relaxed) + 1,
+                          std::memory_order_relaxed);
+        }
+        
+        ParamId add(ParamHandler handler, bool is_event) {
+            const uint8_t count = slot_count_.load(std::memory_order_relaxed);
+            if (count >= KOEKIT_MAX_PARAMS || !handler) {
+                return INVALID_PARAM;
+            }
+            slots_[count].handler = handler;
+            slots_[count].is_event = is_event;
+            // Publish the handler before the id becomes usable
+            slot_count_.store(count + 1, std::memory_order_release);
+            return count;
+        }
+        
+        bool valid(ParamId id, bool is_event) const {
+            return id < slot_count_.load(std::memory_order_relaxed) &&
+                   slots_[id].is_event == is_event;
+        }
+        
+    public:
+        //---------------------------------------------------------------------
+        // Producer side (setup() / loop())
+        //---------------------------------------------------------------------
+        
+        /**
+         * @brief Register a coalescing parameter
+         * @param handler Called on the audio thread with the latest value
+         * @return Parameter id, or INVALID_PARAM if KOEKIT_MAX_PARAMS are in use
+         */
+        ParamId addParameter(ParamHandler handler) {
+            return add(handler, false);
+        }
+        
+        /**
+         * @brief Register an event (note on/off, trigger, ...)
+         * @param handler Called on the audio thread once per event
+         * @return Event id, or INVALID_PARAM if KOEKIT_MAX_PARAMS are in use
+         */
+        ParamId addEvent(ParamHandler handler) {
+            return add(handler, true);
+        }
+        
+        /**
+         * @brief Post a new parameter value
+         * @param id Parameter id from addParameter()
+         * @param value New value
+         * @return false if the id is not a parameter or the queue is full
+         */
+        bool set(ParamId id, float value) {
+            if (!valid(id, false)) {
+                return false;
+            }
+            Slot& slot = slots_[id];
+            slot.value.store(value, std::memory_order_relaxed);
+            // Pairs with the fence in process(): either the consumer reads
+            // this value, or we see it took the queued id and queue again
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (slot.queued != slot.taken.load(std::memory_order_relaxed)) {
+                return true;    // Still queued; it will pick up the new value
+            }
+            if (!queue_.push(Message{id, false, 0.0f, 0})) {
+                return false;
+            }
+            ++slot.queued;
+            return true;
+        }
+        
+        /**
+         * @brief Queue an event
+         * @param id Event id from addEvent()
+         * @param value Event argument (velocity, note, ...)
+         * @return false if the id is not an event or the queue is full
+         */
+        bool send(ParamId id, float value = 1.0f) {
+            if (!valid(id, true)) {
+                return false;
+            }
+            return queue_.push(Message{id, false, value, 0});
+        }
+        
+        /**
+         * @brief Queue a parameter value or event for an exact render frame
+         * 
+         * Timed parameter values are not coalesced. A frame that has
+         * already been rendered is applied at the start of the next block
+         * and counted as late.
+         * 
+         * @param id Parameter or event id
+         * @param value Parameter value or event argument
+         * @param frame Render frame (see AudioEngine::getFrameTime())
+         * @return false if the id is unknown or the queue is full
+         */
+        bool schedule(ParamId id, float value, uint32_t frame) {
+            if (id >= slot_count_.load(std::memory_order_relaxed)) {
+                return false;
+            }
+            return queue_.push(Message{id, true, value, frame});
+        }
+        
+        /**
+         * @brief Messages dropped because the queue or the schedule was full
+         */
+        uint32_t getDroppedCount() const {
+            return queue_.dropped() + schedule_dropped_.load(std::memory_order_relaxed);
+        }
+        
+        /**
+         * @brief Timed messages applied after their frame had been rendered
+         */
+        uint32_t getLateCount() const {
+            return late_.load(std::memory_order_relaxed);
+        }
+        
+        //---------------------------------------------------------------------
+        // Consumer side (audio thread)
+        //---------------------------------------------------------------------
+        
+        /**
+         * @brief Apply everything queued so far
+         */
+        void process() {
+            const uint8_t count = slot_count_.load(std::memory_order_acquire);
+            Message message;
+            while (queue_.pop(message)) {
+                if (message.id >= count) {
+                    continue;
+                }
+                if (message.timed) {
+                    insert(message);
+                    continue;
+                }
+                Slot& slot = slots_[message.id];
+                if (slot.is_event) {
+                    slot.handler(message.value);
+                    continue;
+                }
+                slot.taken.store(slot.taken.load(std::memory_order_relaxed) + 1,
+                                 std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                slot.handler(slot.value.load(std::memory_order_relaxed));
+            }
+        }
+        
+        /**
+         * @brief Apply timed messages due at a frame
+         * @param now Frame about to be rendered
+         * @param max_frames Frames left in the block
+         * @return Frames that can be rendered before the next timed message
+         *         (at least 1, at most max_frames)
+         */
+        size_t dispatch(uint32_t now, size_t max_frames) {
+            while (scheduled_count_ > 0) {
+                const Message& next = scheduled_[scheduled_count_ - 1];
+                const int32_t wait = until(next.frame, now);
+                if (wait > 0) {
+                    return std::min(max_frames, static_cast<size_t>(wait));
+                }
+                if (wait < 0) {
+                    bump(late_);
+                }
+                slots_[next.id].handler(next.value);
+                --scheduled_count_;
+            }
+            return max_frames;
+        }
+        
+        /**
+         * @brief Drop every timed message (consumer side, or while stopped)
+         */
+        void clearSchedule() {
+            scheduled_count_ = 0;
+        }
+        
+    private:
+        void insert(const Message& message) {
+            if (scheduled_count_ >= KOEKIT_SCHEDULE_SIZE) {
+                bump(schedule_dropped_);
+                return;
+            }
+            // Entries due no later than this one stay behind it, so equal
+            // stamps keep their queue order
+            size_t i = scheduled_count_;
+            while (i > 0 && until(scheduled_[i - 1].frame, message.frame) <= 0) {
+                scheduled_[i] = scheduled_[i - 1];
+                --i;
+            }
+            scheduled_[i] = message;
+            ++scheduled_count_;
+        }
+    };
+
+} // namespace KoeKit
+
+#endif // KOEKIT_PARAM_QUEUE_H
@@ -0,0 +1,172 @@
+#pragma once
+
+/**
+ * @file pwm_convert.h
+ * @brief Float sample to PWM level conversion shared by the PWM outputs
+ */
+
+#ifndef KOEKIT_PWM_CONVERT_H
+#define KOEKIT_PWM_CONVERT_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include "filter.h"
+
+namespace KoeKit {
+namespace PWM {
+    
+    constexpr uint16_t RESOLUTION = 12;                        ///< 12-bit PWM
+    constexpr uint16_t MAX_VALUE = (1 << RESOLUTION) - 1;
+    constexpr uint16_t CENTER = MAX_VALUE / 2;                 ///< Silence
+    
+    /**
+     * @brief Convert float sample to PWM level
+     * @param sample Float sample (-1.0 to 1.0)
+     * @return PWM level (0 to MAX_VALUE)
+     */
+    inline uint16_t fromSample(float sample) noexcept {
+        // Clamp sample to valid range
+        sample = std::clamp(sample, -1.0f, 1.0f);
+        
+        // Convert to PWM range
+        const float scaled = (sample + 1.0f) * 0.5f; // 0.0 to 1.0
+        const uint16_t pwm_value = static_cast<uint16_t>(scaled * MAX_VALUE);
+        
+        return std::clamp(pwm_value, static_cast<uint16_t>(0), MAX_VALUE);
+    }
+    
+    /**
+     * @brief Block float to PWM level conversion
+     * 
+     * Converts a whole block in one pass, rounding instead of truncating,
+     * with optional TPDF dither (+/-1 LSB triangular noise) to decorrelate
+     * the quantization error from the signal at low levels, and an optional
+     * DC blocker fused into the same loop (Filter::DCBlocker recurrence).
+     * The options are resolved once per block, so the inner loop has no
+     * branches and is unrolled by four.
+     */
+    class BlockConverter {
+    private:
+        static constexpr float SCALE = MAX_VALUE * 0.5f;  // -1.0..1.0 to +/-2047.5 LSB
+        static constexpr float TPDF_SCALE = 1.0f / 65536.0f;
+        static constexpr float SILENT_TAIL = 0.25f / SCALE;  // Quarter LSB
+        
+        Filter::DCBlocker dc_blocker_;
+        uint32_t rng_state_ = 0x9E3779B9u;
+        bool dither_ = false;
+        bool dc_block_ = false;
+        
+    public:
+        /**
+         * @brief Enable or disable TPDF dither
+         */
+        void setDither(bool enabled) noexcept { dither_ = enabled; }
+        
+        /**
+         * @brief Enable or disable the DC blocker
+         */
+        void setDCBlock(bool enabled) noexcept { dc_block_ = enabled; }
+        
+        bool getDither() const noexcept { return dither_; }
+        bool getDCBlock() const noexcept { return dc_block_; }
+        
+        /**
+         * @brief Clear the DC blocker state
+         */
+        void reset() noexcept { dc_blocker_.reset(); }
+        
+        /**
+         * @brief Fill the levels for a block of digital silence
+         * 
+         * Writes CENTER without converting (or dithering) anything. With
+         * the DC blocker on, only once its tail is below a quarter LSB;
+         * the blocker is then cleared so it stays settled.
+         * 
+         * @param out PWM levels
+         * @param frames Number of samples
+         * @param stride Distance between samples in `out`
+         * @return false if the DC blocker still rings: convert() the block instead
+         */
+        bool fillSilence(uint16_t* out, size_t frames, size_t stride = 1) noexcept {
+            if (dc_block_) {
+                if (!dc_blocker_.isSilent(SILENT_TAIL)) {
+                    return false;
+                }
+                dc_blocker_.reset();
+            }
+            for (size_t i = 0; i < frames * stride; i += stride) {
+                out[i] = CENTER;
+            }
+            return true;
+        }
+        
+        /**
+         * @brief Convert a block of samples to PWM levels
+         * 
+         * One converter per channel: the DC blocker keeps per-stream state.
+         * 
+         * @param in Float samples (-1.0 to 1.0)
+         * @param out PWM levels (0 to MAX_VALUE)
+         * @param frames Number of samples
+         * @param stride Distance between samples in `in` and `out` (channel count
+         *               for one channel of an interleaved block)
+         * @return Number of samples that had to be clipped
+         */
+        uint32_t convert(const float* in, uint16_t* out, size_t frames,
+                         size_t stride = 1) noexcept {
+            if (dc_block_) {
+                return dither_ ? run<true, true>(in, out, frames, stride)
+                               : run<false, true>(in, out, frames, stride);
+            }
+            return dither_ ? run<true, false>(in, out, frames, stride)
+                           : run<false, false>(in, out, frames, stride);
+        }
+        
+    private:
+        template<bool DITHER, bool DC_BLOCK>
+        inline uint32_t convertOne(float x, uint16_t& out) noexcept {
+            if constexpr (DC_BLOCK) {
+                x = dc_blocker_.process(x);
+            }
+            const uint32_t clipped = (x > 1.0f) | (x < -1.0f);
+            
+            // CENTER + 0.5 rounds to nearest and maps 0.0 exactly to CENTER
+            float level = x * SCALE + (CENTER + 0.5f);
+            if constexpr (DITHER) {
+                // One xorshift draw gives two uniform 16-bit values;
+                // their difference is triangular over +/-1 LSB
+                rng_state_ ^= rng_state_ << 13;
+                rng_state_ ^= rng_state_ >> 17;
+                rng_state_ ^= rng_state_ << 5;
+                const int32_t tpdf = static_cast<int32_t>(rng_state_ & 0xFFFF) -
+                                     static_cast<int32_t>(rng_state_ >> 16);
+                level += static_cast<float>(tpdf) * TPDF_SCALE;
+            }
+            level = std::min(std::max(level, 0.0f), static_cast<float>(MAX_VALUE));
+            out = static_cast<uint16_t>(level);
+            return clipped;
+        }
+        
+        template<bool DITHER, bool DC_BLOCK>
+        uint32_t run(const float* in, uint16_t* out, size_t frames, size_t stride) noexcept {
+            uint32_t clipped = 0;
+            if (stride == 1) {
+#pragma GCC unroll 4
+                for (size_t i = 0; i < frames; ++i) {
+                    clipped += convertOne<DITHER, DC_BLOCK>(in[i], out[i]);
+                }
+                return clipped;
+            }
+#pragma GCC unroll 4
+            for (size_t i = 0; i < frames * stride; i += stride) {
+                clipped += convertOne<DITHER, DC_BLOCK>(in[i], out[i]);
+            }
+            return clipped;
+        }
+    };
+
+} // namespace PWM
+} // namespace KoeKit
+
+#endif // KOEKIT_PWM_CONVERT_H
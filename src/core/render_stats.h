@@ -0,0 +1,279 @@
+#pragma once
+
+/**
+ * @file render_stats.h
+ * @brief Render timing, CPU load and deadline-miss measurement for KoeKit
+ */
+
+#ifndef KOEKIT_RENDER_STATS_H
+#define KOEKIT_RENDER_STATS_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(ARDUINO_ARCH_RP2040)
+#include "hardware/clocks.h"
+#include "hardware/timer.h"
+// The cycle counter is in the Cortex-M33 debug unit; the RP2350's Hazard3
+// RISC-V cores have none
+#if defined(PICO_RP2350) && defined(__ARM_ARCH_8M_MAIN__) && !PICO_RISCV
+#define KOEKIT_TIMING_DWT 1
+#include "hardware/structs/m33.h"
+#endif
+#else
+#include <chrono>
+#endif
+
+#ifndef KOEKIT_STATS_HISTOGRAM_BINS
+#define KOEKIT_STATS_HISTOGRAM_BINS 8
+#endif
+
+namespace KoeKit {
+    
+    /**
+     * @brief Cheapest available high-resolution time source
+     *
+     * The Cortex-M33 cycle counter on RP2350 (Arm cores), the microsecond
+     * timer on RP2040 and the RP2350's RISC-V cores, and steady_clock on a
+     * host. Readings wrap; only differences
+     * of under 2^32 ticks are meaningful.
+     */
+    namespace Timing {
+        
+        /**
+         * @brief Enable the counter (idempotent)
+         */
+        inline void begin() {
+#if defined(KOEKIT_TIMING_DWT)
+            m33_hw->demcr |= M33_DEMCR_TRCENA_BITS;
+            m33_hw->dwt_ctrl |= M33_DWT_CTRL_CYCCNTENA_BITS;
+#endif
+        }
+        
+        /**
+         * @brief Current counter value
+         */
+        inline uint32_t now() {
+#if defined(KOEKIT_TIMING_DWT)
+            return m33_hw->dwt_cyccnt;
+#elif defined(ARDUINO_ARCH_RP2040)
+            return time_us_32();
+#else
+            const auto t = std::chrono::steady_clock::now().time_since_epoch();
+            return static_cast<uint32_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(t).count());
+#endif
+        }
+        
+        /**
+         * @brief Counter ticks per second
+         */
+        inline uint32_t ticksPerSecond() {
+#if defined(KOEKIT_TIMING_DWT)
+            return clock_get_hz(clk_sys);
+#elif defined(ARDUINO_ARCH_RP2040)
+            return 1000000;
+#else
+            return 1000000000;
+#endif
+        }
+    }
+    
+    /**
+     * @brief Snapshot of render timing
+     *
+     * A render call's budget is the real time its frames cover. That is
+     * its actual deadline because every output renders ahead of playback,
+     * outside its sample tick: the PWM output a block ahead in a
+     * low-priority interrupt, the DMA output into its ring, DUAL_CORE on
+     * core1. A call that renders inside a single sample period would have
+     * one period as its deadline, not the block.
+     */
+    struct RenderStats {
+        static constexpr size_t HISTOGRAM_BINS = KOEKIT_STATS_HISTOGRAM_BINS;
+        
+        float min_us = 0.0f;            ///< Fastest render call
+        float mean_us = 0.0f;           ///< Mean render call (recent calls weigh most)
+        float max_us = 0.0f;            ///< Slowest render call
+        float budget_us = 0.0f;         ///< Real time covered by one BLOCK_SIZE block
+        float cpu_load = 0.0f;          ///< Percent of real time spent rendering
+        uint32_t calls = 0;             ///< Render calls measured
+        uint32_t idle_calls = 0;        ///< Calls filled with silence without running the callback
+        uint32_t deadline_misses = 0;   ///< Calls that took longer than the audio they produced
+        uint32_t clipped_samples = 0;   ///< Samples outside -1.0..1.0 at the output
+        
+        /**
+         * @brief Render calls by time used, in quarters of their budget
+         *
+         * Bin i counts calls that used i/4 to (i+1)/4 of the real time they
+         * rendered; the last bin also holds everything slower.
+         */
+        std::array<uint32_t, HISTOGRAM_BINS> histogram = {};
+    };
+    
+    /**
+     * @brief Lock-free render timing accumulator
+     *
+     * record() is called by the single render context (PWM render
+     * interrupt, DMA interrupt or core1) and only does relaxed atomic stores, so it
+     * never blocks. snapshot() may run anywhere; fields are read one at a
+     * time, so a snapshot taken mid-update can mix two consecutive calls.
+     * The load and mean sums are halved when they grow large, so they
+     * follow recent behaviour and never overflow.
+     */
+    class RenderStatsCollector {
+    private:
+        static constexpr uint32_t DECAY_THRESHOLD = 1u << 30;
+        
+        uint32_t ticks_per_second_ = 1;
+        uint32_t ticks_per_us_ = 1;
+        uint32_t ticks_per_frame_ = 0;
+        
+        std::atomic<uint32_t> calls_{0};
+        std::atomic<uint32_t> idle_calls_{0};
+        std::atomic<uint32_t> misses_{0};
+        std::atomic<uint32_t> min_ticks_{UINT32_MAX};
+        std::atomic<uint32_t> max_ticks_{0};
+        std::atomic<uint32_t> busy_ticks_{0};      // Decayed sum of render time
+        std::atomic<uint32_t> budget_ticks_{0};    // Decayed sum of real time rendered
+        std::atomic<uint32_t> window_calls_{0};    // Decayed call count
+        std::array<std::atomic<uint32_t>, RenderStats::HISTOGRAM_BINS> histogram_ = {};
+        
+        static void bump(std::atomic<uint32_t>& counter, uint32_t amount = 1) {
+            counter.store(counter.load(std::memory_order_relaxed) + amount,
+                          std::memory_order_relaxed);
+        }
+        
+    public:
+        /**
+         * @brief Set the rate the budget is computed from and clear the counters
+         * @param sample_rate Sample rate in Hz
+         */
+        void begin(uint32_t sample_rate) {
+            Timing::begin();
+            ticks_per_second_ = Timing::ticksPerSecond();
+            ticks_per_us_ = ticks_per_second_ >= 1000000 ? ticks_per_second_ / 1000000 : 1;
+            ticks_per_frame_ = sample_rate > 0 ? ticks_per_second_ / sample_rate : 0;
+            reset();
+        }
+        
+        /**
+         * @brief Ticks of real time a number of frames covers
+         * @param frames Number of frames
+         */
+        uint32_t budgetTicks(size_t frames) const {
+            return ticks_per_frame_ * static_cast<uint32_t>(frames);
+        }
+        
+        /**
+         * @brief Convert counter ticks to whole microseconds
+         * @param ticks Tick count
+         */
+        uint32_t ticksToMicros(uint32_t ticks) const {
+            return ticks / ticks_per_us_;
+        }
+        
+        /**
+         * @brief Account one render call (render context only)
+         * @param elapsed Ticks the call took
+         * @param frames Frames it rendered
+         * @param idle true if the callback was bypassed for the whole call
+         */
+        void record(uint32_t elapsed, size_t frames, bool idle = false) {
+            const uint32_t budget = budgetTicks(frames);
+            
+            bump(calls_);
+            if (idle) {
+                bump(idle_calls_);
+            }
+            // Without a budget (begin() not called) there is no deadline
+            if (budget > 0 && elapsed > budget) {
+                bump(misses_);
+            }
+            if (elapsed < min_ticks_.load(std::memory_order_relaxed)) {
+                min_ticks_.store(elapsed, std::memory_order_relaxed);
+            }
+            if (elapsed > max_ticks_.load(std::memory_order_relaxed)) {
+                max_ticks_.store(elapsed, std::memory_order_relaxed);
+            }
+            
+            if (budget > 0) {
+                size_t bin = RenderStats::HISTOGRAM_BINS - 1;
+                const uint64_t quarters = static_cast<uint64_t>(elapsed) * 4 / budget;
+                if (quarters < bin) {
+                    bin = static_cast<size_t>(quarters);
+                }
+                bump(histogram_[bin]);
+            }
+            
+            uint32_t busy = busy_ticks_.load(std::memory_order_relaxed) + elapsed;
+            uint32_t total = budget_ticks_.load(std::memory_order_relaxed) + budget;
+            uint32_t window = window_calls_.load(std::memory_order_relaxed) + 1;
+            if (total >= DECAY_THRESHOLD || busy >= DECAY_THRESHOLD) {
+                busy >>= 1;
+                total >>= 1;
+                window = (window + 1) >> 1;
+            }
+            busy_ticks_.store(busy, std::memory_order_relaxed);
+            budget_ticks_.store(total, std::memory_order_relaxed);
+            window_calls_.store(window, std::memory_order_relaxed);
+        }
+        
+        /**
+         * @brief Read the current statistics
+         * @param clipped_samples Clip count reported by the output
+         * @return Statistics snapshot
+         */
+        RenderStats snapshot(uint32_t clipped_samples) const {
+            RenderStats stats;
+            const float us_per_tick = 1e6f / static_cast<float>(ticks_per_second_);
+            
+            stats.calls = calls_.load(std::memory_order_relaxed);
+            stats.idle_calls = idle_calls_.load(std::memory_order_relaxed);
+            stats.deadline_misses = misses_.load(std::memory_order_relaxed);
+            stats.clipped_samples = clipped_samples;
+            stats.budget_us = static_cast<float>(ticks_per_frame_) * BLOCK_SIZE * us_per_tick;
+            for (size_t i = 0; i < RenderStats::HISTOGRAM_BINS; ++i) {
+                stats.histogram[i] = histogram_[i].load(std::memory_order_relaxed);
+            }
+            
+            if (stats.calls > 0) {
+                stats.min_us = min_ticks_.load(std::memory_order_relaxed) * us_per_tick;
+                stats.max_us = max_ticks_.load(std::memory_order_relaxed) * us_per_tick;
+            }
+            
+            const uint32_t busy = busy_ticks_.load(std::memory_order_relaxed);
+            const uint32_t total = budget_ticks_.load(std::memory_order_relaxed);
+            const uint32_t window = window_calls_.load(std::memory_order_relaxed);
+            if (window > 0) {
+                stats.mean_us = static_cast<float>(busy) / window * us_per_tick;
+            }
+            if (total > 0) {
+                stats.cpu_load = 100.0f * static_cast<float>(busy) / static_cast<float>(total);
+            }
+            return stats;
+        }
+        
+        /**
+         * @brief Clear all counters
+         */
+        void reset() {
+            calls_.store(0, std::memory_order_relaxed);
+            idle_calls_.store(0, std::memory_order_relaxed);
+            misses_.store(0, std::memory_order_relaxed);
+            min_ticks_.store(UINT32_MAX, std::memory_order_relaxed);
+            max_ticks_.store(0, std::memory_order_relaxed);
+            busy_ticks_.store(0, std::memory_order_relaxed);
+            budget_ticks_.store(0, std::memory_order_relaxed);
+            window_calls_.store(0, std::memory_order_relaxed);
+            for (auto& bin : histogram_) {
+                bin.store(0, std::memory_order_relaxed);
+            }
+        }
+    };
+
+} // namespace KoeKit
+
+#endif // KOEKIT_RENDER_STATS_H
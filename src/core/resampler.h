@@ -0,0 +1,228 @@
+#pragma once
+
+/**
+ * @file resampler.h
+ * @brief Polyphase sample-rate converter for KoeKit
+ */
+
+#ifndef KOEKIT_RESAMPLER_H
+#define KOEKIT_RESAMPLER_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace KoeKit {
+    
+    /**
+     * @brief Resampler quality / cost tradeoff
+     */
+    enum class ResampleQuality : uint8_t {
+        FAST,       ///< 8 taps, 32 phases, no phase interpolation
+        BALANCED,   ///< 16 taps, 64 phases, interpolated phases
+        BEST        ///< 32 taps, 128 phases, interpolated phases
+    };
+    
+    /**
+     * @brief Polyphase windowed-sinc resampler for any rate ratio
+     *
+     * The filter is one Kaiser-windowed sinc sampled at PHASES points per
+     * input sample and stored as a table of phases, built once in begin().
+     * Each output sample is a dot product of TAPS input samples with the
+     * phase at or below its position; BALANCED and BEST also evaluate the next
+     * phase and interpolate linearly between the two. The read position
+     * advances in 32.32 fixed point, so the ratio never drifts. When
+     * downsampling, the cutoff follows the output rate and the tap count
+     * grows with the ratio.
+     *
+     * Input is pulled from a source in blocks of CHANNELS interleaved
+     * samples, the same shape as AudioOutput::Source. Adds TAPS / 2 input
+     * samples of latency.
+     */
+    class Resampler {
+    public:
+        using Source = void (*)(float* out, size_t frames, void* context);
+        
+    private:
+        std::vector<float> table_;      // (phases_ + 1) rows of taps_ coefficients
+        std::vector<float> history_;    // Interleaved input frames
+        size_t taps_ = 0;
+        size_t phases_ = 0;
+        size_t pull_frames_ = 0;
+        size_t valid_frames_ = 0;       // Frames of input in history_
+        uint64_t position_ = 0;         // 32.32 read position in history_
+        uint64_t step_ = 0;             // Input frames per output frame, 32.32
+        bool interpolate_ = false;
+        bool active_ = false;
+        
+        static constexpr double PI = 3.14159265358979323846;
+        
+        static double besselI0(double x) {
+            double sum = 1.0;
+            double term = 1.0;
+            for (int k = 1; k < 32; ++k) {
+                term *= (x / (2.0 * k)) * (x / (2.0 * k));
+                sum += term;
+            }
+            return sum;
+        }
+        
+    public:
+        /**
+         * @brief Build the phase table and clear the history
+         * @param in_rate Rate the source renders at (Hz)
+         * @param out_rate Rate process() produces (Hz)
+         * @param quality Taps, phases and interpolation
+         * @param pull_frames Frames requested from the source per pull
+         * @return false if the rates are invalid
+         */
+        bool begin(uint32_t in_rate, uint32_t out_rate,
+                   ResampleQuality quality = ResampleQuality::BALANCED,
+                   size_t pull_frames = BLOCK_SIZE) {
+            active_ = false;
+            if (in_rate == 0 || out_rate == 0 || pull_frames == 0) {
+                return false;
+            }
+            
+            size_t base_taps = 16;
+            double beta = 7.0;
+            double rolloff = 0.88;
+            switch (quality) {
+                case ResampleQuality::FAST:
+                    base_taps = 8;  phases_ = 32;  beta = 5.0; rolloff = 0.80; interpolate_ = false;
+                    break;
+                case ResampleQuality::BALANCED:
+                    base_taps = 16; phases_ = 64;  beta = 7.0; rolloff = 0.88; interpolate_ = true;
+                    break;
+                case ResampleQuality::BEST:
+                    base_taps = 32; phases_ = 128; beta = 9.0; rolloff = 0.92; interpolate_ = true;
+                    break;
+            }
+            
+            // Downsampling: lower the cutoff and widen the kernel to match
+            const double ratio = static_cast<double>(out_rate) / in_rate;
+            const double scale = std::min(1.0, ratio);
+            const size_t widen = static_cast<size_t>(std::ceil(1.0 / scale));
+            taps_ = base_taps * widen;
+            const double cutoff = 0.5 * scale * rolloff;        // Cycles per input sample
+            const double half = static_cast<double>(taps_) / 2.0;
+            const double center = half - 1.0;                   // Tap aligned with the read position
+            
+            table_.assign((phases_ + 1) * taps_, 0.0f);
+            for (size_t p = 0; p <= phases_; ++p) {
+                const double frac = static_cast<double>(p) / phases_;
+                double sum = 0.0;
+                for (size_t j = 0; j < taps_; ++j) {
+                    const double t = static_cast<double>(j) - center - frac;
+                    const double x = 2.0 * cutoff * t;
+                    const double sinc = (std::abs(x) < 1e-9) ? 1.0 : std::sin(PI * x) / (PI * x);
+                    const double r = t / half;
+                    const double window = (std::abs(r) >= 1.0)
+                        ? 0.0 : besselI0(beta * std::sqrt(1.0 - r * r)) / besselI0(beta);
+                    const double h = 2.0 * cutoff * sinc * window;
+                    table_[p * taps_ + j] = static_cast<float>(h);
+                    sum += h;
+                }
+                // Unity gain at DC for every phase
+                for (size_t j = 0; j < taps_; ++j) {
+                    table_[p * taps_ + j] = static_cast<float>(table_[p * taps_ + j] / sum);
+                }
+            }
+            
+            pull_frames_ = pull_frames;
+            history_.assign((taps_ + pull_frames_) * CHANNELS, 0.0f);
+            step_ = (static_cast<uint64_t>(in_rate) << 32) / out_rate;
+            reset();
+            active_ = true;
+            return true;
+        }
+        
+        /**
+         * @brief Clear the history (keeps the table)
+         */
+        void reset() {
+            std::fill(history_.begin(), history_.end(), 0.0f);
+            // Zeros before the first input sample so it lands on the center tap
+            valid_frames_ = taps_ / 2 - 1;
+            position_ = 0;
+        }
+        
+        /**
+         * @brief Produce output frames, pulling input as needed
+         * @param out Output buffer (frames * CHANNELS samples)
+         * @param frames Number of output frames
+         * @param source Input block source
+         * @param context User pointer passed back to the source
+         */
+        void process(float* out, size_t frames, Source source, void* context) {
+            for (size_t i = 0; i < frames; ++i) {
+                size_t start = static_cast<size_t>(position_ >> 32);
+                if (start + taps_ > valid_frames_) {
+                    refill(start, source, context);
+                    start = static_cast<size_t>(position_ >> 32);
+                }
+                
+                const uint32_t frac = static_cast<uint32_t>(position_);
+                const uint64_t scaled = static_cast<uint64_t>(frac) * phases_;
+                const size_t phase = static_cast<size_t>(scaled >> 32);
+                const float* h0 = &table_[phase * taps_];
+                const float* x = &history_[start * CHANNELS];
+                
+                for (size_t c = 0; c < CHANNELS; ++c) {
+                    float y0 = 0.0f;
+                    for (size_t j = 0; j < taps_; ++j) {
+                        y0 += h0[j] * x[j * CHANNELS + c];
+                    }
+                    if (interpolate_) {
+                        const float* h1 = h0 + taps_;
+                        float y1 = 0.0f;
+                        for (size_t j = 0; j < taps_; ++j) {
+                            y1 += h1[j] * x[j * CHANNELS + c];
+                        }
+                        const float w = static_cast<float>(static_cast<uint32_t>(scaled)) *
+                                        (1.0f / 4294967296.0f);
+                        y0 += (y1 - y0) * w;
+                    }
+                    out[i * CHANNELS + c] = y0;
+                }
+                position_ += step_;
+            }
+        }
+        
+        bool isActive() const { return active_; }
+        
+        /**
+         * @brief Input frames of delay added by the filter
+         */
+        size_t latencyFrames() const { return taps_ / 2; }
+        
+        /**
+         * @brief Taps per output sample (per phase evaluated)
+         */
+        size_t taps() const { return taps_; }
+        
+    private:
+        /**
+         * @brief Drop consumed input and pull blocks until a full window is available
+         */
+        void refill(size_t start, Source source, void* context) {
+            // Keep only frames at or after the current window start
+            const size_t keep = valid_frames_ > start ? valid_frames_ - start : 0;
+            std::copy(history_.begin() + start * CHANNELS,
+                      history_.begin() + (start + keep) * CHANNELS,
+                      history_.begin());
+            position_ -= static_cast<uint64_t>(start) << 32;
+            valid_frames_ = keep;
+            
+            while (valid_frames_ < taps_) {
+                source(&history_[valid_frames_ * CHANNELS], pull_frames_, context);
+                valid_frames_ += pull_frames_;
+            }
+        }
+    };
+
+} // namespace KoeKit
+
+#endif // KOEKIT_RESAMPLER_H
@@ -0,0 +1,119 @@
+#pragma once
+
+/**
+ * @file spsc_queue.h
+ * @brief Wait-free single-producer/single-consumer message queue
+ */
+
+#ifndef KOEKIT_SPSC_QUEUE_H
+#define KOEKIT_SPSC_QUEUE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace KoeKit {
+    
+    /**
+     * @brief Bounded queue of small records shared by one producer and one consumer
+     *
+     * Records are copied in and out by value. Like BlockRing, each side owns
+     * one counter, so push() and pop() never wait and never fail halfway.
+     *
+     * @tparam T Trivially copyable record type
+     * @tparam CAPACITY Number of records (power of two, at least 2)
+     */
+    template<typename T, size_t CAPACITY>
+    class SPSCQueue {
+        static_assert(CAPACITY >= 2 && (CAPACITY & (CAPACITY - 1)) == 0,
+                      "CAPACITY must be a power of two");
+        
+    private:
+        static constexpr uint32_t INDEX_MASK = CAPACITY - 1;
+        
+        std::array<T, CAPACITY> records_ = {};
+        std::atomic<uint32_t> write_count_{0};   // Records pushed by the producer
+        std::atomic<uint32_t> read_count_{0};    // Records popped by the consumer
+        std::atomic<uint32_t> dropped_{0};       // Written by the producer only
+        
+    public:
+        /**
+         * @brief Append a record (producer only)
+         * @param record Record to copy in
+         * @return false if the queue was full; the record is dropped
+         */
+        bool push(const T& record) noexcept {
+            const uint32_t write = write_count_.load(std::memory_order_relaxed);
+            const uint32_t read = read_count_.load(std::memory_order_acquire);
+            if (write - read >= CAPACITY) {
+                dropped_.store(dropped_.load(std::memory_order_relaxed) + 1,
+                               std::memory_order_relaxed);
+                return false;
+            }
+            records_[write & INDEX_MASK] = record;
+            write_count_.store(write + 1, std::memory_order_release);
+            return true;
+        }
+        
+        /**
+         * @brief Look at the oldest record without removing it (consumer only)
+         * @return Pointer to the record, or nullptr if the queue is empty
+         */
+        const T* peek() const noexcept {
+            const uint32_t read = read_count_.load(std::memory_order_relaxed);
+            const uint32_t write = write_count_.load(std::memory_order_acquire);
+            if (write == read) {
+                return nullptr;
+            }
+            return &records_[read & INDEX_MASK];
+        }
+        
+        /**
+         * @brief Remove the oldest record (consumer only)
+         * @param record Receives the record
+         * @return false if the queue was empty
+         */
+        bool pop(T& record) noexcept {
+            const T* front = peek();
+            if (front == nullptr) {
+                return false;
+            }
+            record = *front;
+            const uint32_t read = read_count_.load(std::memory_order_relaxed);
+            read_count_.store(read + 1, std::memory_order_release);
+            return true;
+        }
+        
+        /**
+         * @brief Number of records waiting
+         */
+        size_t size() const noexcept {
+            return write_count_.load(std::memory_order_acquire) -
+                   read_count_.load(std::memory_order_acquire);
+        }
+        
+        /**
+         * @brief Records rejected because the queue was full
+         */
+        uint32_t dropped() const noexcept {
+            return dropped_.load(std::memory_order_relaxed);
+        }
+        
+        /**
+         * @brief Drop all records and clear the counters
+         *
+         * Only while producer and consumer are stopped.
+         */
+        void reset() noexcept {
+            write_count_.store(0, std::memory_order_relaxed);
+            read_count_.store(0, std::memory_order_relaxed);
+            dropped_.store(0, std::memory_order_relaxed);
+        }
+        
+        static constexpr size_t capacity() noexcept { return CAPACITY; }
+    };
+
+} // namespace KoeKit
+
+#endif // KOEKIT_SPSC_QUEUE_H
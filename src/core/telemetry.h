@@ -0,0 +1,206 @@
+#pragma once
+
+/**
+ * @file telemetry.h
+ * @brief Real-time-safe binary event log from the audio context to loop()
+ */
+
+#ifndef KOEKIT_TELEMETRY_H
+#define KOEKIT_TELEMETRY_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include "spsc_queue.h"
+
+#ifndef KOEKIT_TELEMETRY_SIZE
+#define KOEKIT_TELEMETRY_SIZE 128
+#endif
+
+namespace KoeKit {
+    
+    /**
+     * @brief Kinds of telemetry records
+     *
+     * The engine writes the built-in kinds itself; VOICE_STEAL and USER
+     * onwards are for the sketch. Values stay below 32 (one enable bit each).
+     */
+    enum class TelemetryEvent : uint8_t {
+        UNDERRUN = 0,       ///< value: silent blocks played since the last record
+        OVERRUN = 1,        ///< value: render ring overruns
+        CLIP = 2,           ///< value: samples clipped at the output
+        NAN_DETECTED = 3,   ///< value: non-finite samples replaced by silence
+        DEADLINE_MISS = 4,  ///< value: render time of the block in us
+        RENDER_TIME = 5,    ///< value: render time of a sampled block in us (off by default)
+        PARAM_DROPPED = 6,  ///< value: parameter/event messages lost
+        PARAM_LATE = 7,     ///< value: scheduled messages applied late
+        INPUT_UNDERRUN = 8, ///< value: input blocks replaced by silence
+        INPUT_SKIP = 9,     ///< value: input blocks dropped to bound latency
+        LOAD_LEVEL = 10,    ///< value: new load governor level
+        VOICE_STEAL = 11,   ///< arg: voice index, value: free for the sketch
+        USER = 16           ///< First of 16 sketch-defined kinds (see userEvent())
+    };
+    
+    /**
+     * @brief Sketch-defined record kind
+     * @param n Kind number (0 to 15)
+     */
+    constexpr TelemetryEvent userEvent(uint8_t n) {
+        return static_cast<TelemetryEvent>(static_cast<uint8_t>(TelemetryEvent::USER) + (n & 15));
+    }
+    
+    /**
+     * @brief One telemetry record (8 bytes, little-endian on every target)
+     */
+    struct TelemetryRecord {
+        uint32_t frame = 0;     ///< Render frame (AudioEngine::getFrameTime()) of the block
+        uint8_t type = 0;       ///< TelemetryEvent
+        uint8_t arg = 0;        ///< Small argument (channel, voice, ...)
+        uint16_t value = 0;     ///< Count or measurement, saturated at 65535
+    };
+    static_assert(sizeof(TelemetryRecord) == 8, "TelemetryRecord must stay 8 bytes");
+    
+    /**
+     * @brief Fixed-size event log written by the render context
+     *
+     * log() checks one enable bit and copies 8 bytes into a wait-free
+     * SPSC queue of KOEKIT_TELEMETRY_SIZE records: no locks, no
+     * allocation, no formatting. loop() takes records out with drain() and
+     * prints them, or sends them on as binary for the host decoder
+     * (extras/host/telemetry_decode.cpp). When loop() falls behind, new
+     * records are dropped and counted.
+     */
+    class TelemetryLog {
+    private:
+        SPSCQueue<TelemetryRecord, KOEKIT_TELEMETRY_SIZE> queue_;
+        std::atomic<uint32_t> mask_{~(1u << static_cast<uint8_t>(TelemetryEvent::RENDER_TIME))};
+        std::atomic<uint32_t> timing_interval_{0};
+        
+        static uint32_t bit(TelemetryEvent type) {
+            return 1u << (static_cast<uint8_t>(type) & 31);
+        }
+        
+    public:
+        /**
+         * @brief Check if a kind of record is being logged
+         */
+        bool enabled(TelemetryEvent type) const {
+            return (mask_.load(std::memory_order_relaxed) & bit(type)) != 0;
+        }
+        
+        /**
+         * @brief Turn one kind of record on or off
+         * @param type Record kind
+         * @param enable true to log it
+         */
+        void setEnabled(TelemetryEvent type, bool enable) {
+            const uint32_t mask = mask_.load(std::memory_order_relaxed);
+            mask_.store(enable ? mask | bit(type) : mask & ~bit(type), std::memory_order_relaxed);
+        }
+        
+        /**
+         * @brief Log the render time of every Nth block as RENDER_TIME
+         * @param blocks Interval in blocks, or 0 to stop
+         */
+        void setTimingInterval(uint32_t blocks) {
+            timing_interval_.store(blocks, std::memory_order_relaxed);
+            setEnabled(TelemetryEvent::RENDER_TIME, blocks > 0);
+        }
+        
+        /**
+         * @brief Blocks between RENDER_TIME records (0 = off)
+         */
+        uint32_t getTimingInterval() const {
+            return timing_interval_.load(std::memory_order_relaxed);
+        }
+        
+        /**
+         * @brief Append a record (render context only)
+         * @param type Record kind
+         * @param frame Render frame
+         * @param arg Small argument
+         * @param value Count or measurement (saturated to 16 bits)
+         * @return false if the kind is disabled or the log is full
+         */
+        bool log(TelemetryEvent type, uint32_t frame, uint8_t arg = 0, uint32_t value = 0) {
+            if (!enabled(type)) {
+                return false;
+            }
+            TelemetryRecord record;
+            record.frame = frame;
+            record.type = static_cast<uint8_t>(type);
+            record.arg = arg;
+            record.value = static_cast<uint16_t>(value < 0xFFFF ? value : 0xFFFF);
+            return queue_.push(record);
+        }
+        
+        /**
+         * @brief Take the oldest records (loop() only)
+         * @param out Destination array
+         * @param max_records Size of the array
+         * @return Number of records copied
+         */
+        size_t drain(TelemetryRecord* out, size_t max_records) {
+            size_t count = 0;
+            while (count < max_records && queue_.pop(out[count])) {
+                ++count;
+            }
+            return count;
+        }
+        
+        /**
+         * @brief Records lost because the log was full
+         */
+        uint32_t getDroppedCount() const { return queue_.dropped(); }
+    };
+    
+    /**
+     * @brief Name of a record kind
+     * @param type TelemetryEvent value
+     * @return Static string ("user" for sketch kinds)
+     */
+    inline const char* telemetryEventName(uint8_t type) {
+        switch (static_cast<TelemetryEvent>(type)) {
+            case TelemetryEvent::UNDERRUN: return "underrun";
+            case TelemetryEvent::OVERRUN: return "overrun";
+            case TelemetryEvent::CLIP: return "clip";
+            case TelemetryEvent::NAN_DETECTED: return "nan";
+            case TelemetryEvent::DEADLINE_MISS: return "deadline-miss";
+            case TelemetryEvent::RENDER_TIME: return "render-time";
+            case TelemetryEvent::PARAM_DROPPED: return "param-dropped";
+            case TelemetryEvent::PARAM_LATE: return "param-late";
+            case TelemetryEvent::INPUT_UNDERRUN: return "input-underrun";
+            case TelemetryEvent::INPUT_SKIP: return "input-skip";
+            case TelemetryEvent::LOAD_LEVEL: return "load-level";
+            case TelemetryEvent::VOICE_STEAL: return "voice-steal";
+            default: return type >= static_cast<uint8_t>(TelemetryEvent::USER) ? "user" : "unknown";
+        }
+    }
+    
+    /**
+     * @brief Print a record as one line of text (loop() or host)
+     * @param record Record to print
+     * @param sample_rate Render rate, to show the frame as a time
+     * @param buffer Destination
+     * @param size Size of the destination
+     * @return Characters written (as snprintf)
+     */
+    inline int formatTelemetry(const TelemetryRecord& record, uint32_t sample_rate,
+                               char* buffer, size_t size) {
+        const double ms = sample_rate > 0 ? 1000.0 * record.frame / sample_rate : 0.0;
+        char name[16];
+        if (record.type >= static_cast<uint8_t>(TelemetryEvent::USER)) {
+            std::snprintf(name, sizeof(name), "user+%u",
+                          record.type - static_cast<unsigned>(TelemetryEvent::USER));
+        } else {
+            std::snprintf(name, sizeof(name), "%s", telemetryEventName(record.type));
+        }
+        return std::snprintf(buffer, size, "%10.3f ms  frame %10lu  %-14s arg %3u  value %5u",
+                             ms, static_cast<unsigned long>(record.frame), name,
+                             record.arg, record.value);
+    }
+
+} // namespace KoeKit
+
+#endif // KOEKIT_TELEMETRY_H
@@ -10,8 +10,11 @@
 
 #include <array>
 #include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <algorithm>
 #include <functional>
+#include <utility>
 
 namespace KoeKit {
     
@@ -25,32 +28,196 @@ namespace KoeKit {
      */
     constexpr float SAMPLE_SCALE = 32767.0f;
     
+    /**
+     * @brief Wavetable storage policy: 16-bit Q15 samples (default)
+     * 
+     * 2 bytes per sample, about 90 dB of dynamic range.
+     */
+    struct Q15Storage {
+        using Sample = WavetableSample;
+        static constexpr float SCALE = SAMPLE_SCALE;    ///< Sample value of 1.0
+        
+        static constexpr Sample encode(float value) {
+            return static_cast<Sample>(std::clamp(value, -1.0f, 1.0f) * SCALE);
+        }
+    };
+    
+    /**
+     * @brief Wavetable storage policy: 32-bit float samples
+     * 
+     * 4 bytes per sample. The lookup kernels use the samples as they are,
+     * with no integer conversion or scaling: the fastest path on the
+     * RP2350's FPU, for tables that fit the flash and cache budget.
+     */
+    struct FloatStorage {
+        using Sample = float;
+        static constexpr float SCALE = 1.0f;
+        
+        static constexpr Sample encode(float value) {
+            return std::clamp(value, -1.0f, 1.0f);
+        }
+    };
+    
+    /**
+     * @brief Wavetable storage policy: 8-bit samples
+     * 
+     * 1 byte per sample, about 42 dB of dynamic range: for large banks in
+     * little flash, or lo-fi tables.
+     */
+    struct Int8Storage {
+        using Sample = int8_t;
+        static constexpr float SCALE = 127.0f;
+        
+        static constexpr Sample encode(float value) {
+            return static_cast<Sample>(std::clamp(value, -1.0f, 1.0f) * SCALE);
+        }
+    };
+    
+    /**
+     * @brief Symmetry a compressed wavetable folds its cycle by
+     */
+    enum class WaveSymmetry : uint8_t {
+        HALF_WAVE,      ///< x(t + T/2) = -x(t): square, triangle, odd-harmonic waves
+        QUARTER_WAVE    ///< Half-wave, and x(T/2 - t) = x(t): sine
+    };
+    
+    /**
+     * @brief Wavetable storage policy: one symmetric part of the cycle
+     * 
+     * Stores only the first half (HALF_WAVE) or quarter (QUARTER_WAVE) of
+     * the cycle in the Base format and rebuilds the rest in the lookup by
+     * folding the phase, for 2x or 4x less flash and cache. The table is
+     * generated from the full cycle as usual, so only use it for waves
+     * that have the symmetry. Use HalfWaveStorage or QuarterWaveStorage.
+     * 
+     * @tparam Base Format of the stored samples (Q15Storage, FloatStorage, Int8Storage)
+     * @tparam SYMMETRY Symmetry of the wave
+     */
+    template<typename Base, WaveSymmetry SYMMETRY>
+    struct SymmetricStorage {
+        using Sample = typename Base::Sample;
+        static constexpr float SCALE = Base::SCALE;
+        
+        static constexpr Sample encode(float value) {
+            return Base::encode(value);
+        }
+    };
+    
+    /**
+     * @brief Half-wave symmetric storage (half the samples)
+     */
+    template<typename Base = Q15Storage>
+    using HalfWaveStorage = SymmetricStorage<Base, WaveSymmetry::HALF_WAVE>;
+    
+    /**
+     * @brief Quarter-wave symmetric storage (a quarter of the samples)
+     */
+    template<typename Base = Q15Storage>
+    using QuarterWaveStorage = SymmetricStorage<Base, WaveSymmetry::QUARTER_WAVE>;
+    
+    namespace Detail {
+        /**
+         * @brief Wrap a fractional table index into 0 to SIZE (exclusive)
+         */
+        template<size_t SIZE>
+        float wrapTableIndex(float index) noexcept {
+            while (index >= SIZE) index -= SIZE;
+            while (index < 0) index += SIZE;
+            // A tiny negative index can round up to exactly SIZE
+            return index < SIZE ? index : 0.0f;
+        }
+        
+        /**
+         * @brief 4-point, 3rd-order Hermite interpolation
+         * @param taps Samples i - 1 to i + 2
+         * @param frac Position between samples i and i + 1
+         */
+        template<typename Sample>
+        float hermite(const Sample* taps, float frac) noexcept {
+            const auto xm1 = static_cast<float>(taps[0]);
+            const auto x0 = static_cast<float>(taps[1]);
+            const auto x1 = static_cast<float>(taps[2]);
+            const auto x2 = static_cast<float>(taps[3]);
+            
+            const float c1 = 0.5f * (x1 - xm1);
+            const float c2 = xm1 - 2.5f * x0 + 2.0f * x1 - 0.5f * x2;
+            const float c3 = 0.5f * (x2 - xm1) + 1.5f * (x0 - x1);
+            return ((c3 * frac + c2) * frac + c1) * frac + x0;
+        }
+    }
+    
     /**
      * @brief Wavetable container with compile-time generation
+     * 
+     * Samples are stored with guard samples around the cycle: a copy of the
+     * last sample before the first and copies of the first two after the
+     * last. Every interpolation tap (up to the 4-point cubic) is then a
+     * plain load at consecutive addresses, with no wrap-around.
+     * 
+     * The storage policy sets the sample type (Q15Storage, FloatStorage or
+     * Int8Storage) and with it the flash, cache and CPU cost of the
+     * table; every lookup kernel is compiled for that type.
+     * 
      * @tparam SIZE Number of samples in the wavetable
+     * @tparam Storage Sample storage policy
      */
-    template<size_t SIZE>
+    template<size_t SIZE, typename Storage = Q15Storage>
     class Wavetable {
     public:
-        using SampleArray = std::array<WavetableSample, SIZE>;
+        using StorageType = Storage;
+        using Sample = typename Storage::Sample;
+        using SampleArray = std::array<Sample, SIZE>;
+        
+        static constexpr size_t GUARD_BEFORE = 1;   ///< Guard samples before sample 0
+        static constexpr size_t GUARD_AFTER = 2;    ///< Guard samples after sample SIZE - 1
+        
+        /**
+         * @brief True if the table can be indexed from a fixed-point phase
+         */
+        static constexpr bool POWER_OF_TWO = SIZE >= 2 && (SIZE & (SIZE - 1)) == 0;
         
     private:
-        SampleArray samples_;
+        std::array<Sample, GUARD_BEFORE + SIZE + GUARD_AFTER> storage_;
+        
+        // Fixed-point phase layout: the top INDEX_BITS select the sample,
+        // the FRAC_BITS below them are the position between samples
+        static constexpr uint32_t indexBits() {
+            uint32_t bits = 0;
+            while ((static_cast<size_t>(1) << bits) < SIZE) {
+                ++bits;
+            }
+            return bits;
+        }
+        static constexpr uint32_t INDEX_BITS = indexBits();
+        static constexpr uint32_t FRAC_BITS = 32 - INDEX_BITS;
+        static constexpr uint32_t FRAC_MASK = 0xFFFFFFFFu >> INDEX_BITS;
+        static constexpr float FRAC_SCALE = 1.0f / static_cast<float>(1ull << FRAC_BITS);
+        static constexpr float INV_SCALE = 1.0f / Storage::SCALE;
         
     public:
         /**
          * @brief Construct wavetable from sample array
-         * @param samples Pre-computed sample array
+         * @param samples Pre-computed sample array (one cycle, no guards)
          */
-        constexpr Wavetable(const SampleArray& samples) : samples_(samples) {}
+        constexpr Wavetable(const SampleArray& samples) : storage_{} {
+            for (size_t i = 0; i < SIZE; ++i) {
+                storage_[GUARD_BEFORE + i] = samples[i];
+            }
+            for (size_t i = 0; i < GUARD_BEFORE; ++i) {
+                storage_[i] = samples[(SIZE - GUARD_BEFORE + i) % SIZE];
+            }
+            for (size_t i = 0; i < GUARD_AFTER; ++i) {
+                storage_[GUARD_BEFORE + SIZE + i] = samples[i % SIZE];
+            }
+        }
         
         /**
          * @brief Get sample at exact index (no interpolation)
          * @param index Sample index (will be wrapped)
-         * @return Sample value (-32768 to 32767)
+         * @return Stored sample value (Storage::SCALE = 1.0)
          */
-        constexpr WavetableSample getSample(size_t index) const noexcept {
-            return samples_[index % SIZE];
+        constexpr Sample getSample(size_t index) const noexcept {
+            return storage_[GUARD_BEFORE + index % SIZE];
         }
         
         /**
@@ -59,97 +226,575 @@ namespace KoeKit {
          * @return Interpolated sample value (-1.0 to 1.0)
          */
         float getInterpolated(float index) const noexcept {
-            // Wrap index to table size
-            while (index >= SIZE) index -= SIZE;
-            while (index < 0) index += SIZE;
+            index = Detail::wrapTableIndex<SIZE>(index);
+            
+            const auto i1 = static_cast<size_t>(index);
+            const auto frac = index - static_cast<float>(i1);
+            
+            const Sample* taps = &storage_[GUARD_BEFORE + i1];
+            const auto s1 = static_cast<float>(taps[0]);
+            const auto s2 = static_cast<float>(taps[1]);
+            
+            return (s1 + frac * (s2 - s1)) * INV_SCALE;
+        }
+        
+        /**
+         * @brief Get cubic-interpolated sample at fractional index
+         * 
+         * 4-point Hermite: smoother than linear between samples, with less
+         * high-frequency loss, for four loads and a few more multiplies.
+         * 
+         * @param index Fractional sample index
+         * @return Interpolated sample value (about -1.0 to 1.0; may overshoot slightly)
+         */
+        float getCubic(float index) const noexcept {
+            index = Detail::wrapTableIndex<SIZE>(index);
             
             const auto i1 = static_cast<size_t>(index);
-            const auto i2 = (i1 + 1) % SIZE;
             const auto frac = index - static_cast<float>(i1);
+            return Detail::hermite(&storage_[GUARD_BEFORE + i1 - 1], frac) * INV_SCALE;
+        }
+        
+        /**
+         * @brief Get the sample a fixed-point phase falls on (power-of-two sizes)
+         * @param phase Phase, 2^32 = one cycle (see PhaseAccumulator::tickFixed())
+         * @return Sample value (-1.0 to 1.0)
+         */
+        float lookupNearest(uint32_t phase) const noexcept {
+            static_assert(POWER_OF_TWO, "Fixed-point lookup needs a power-of-two table");
+            return static_cast<float>(storage_[GUARD_BEFORE + (phase >> FRAC_BITS)]) * INV_SCALE;
+        }
+        
+        /**
+         * @brief Get the interpolated sample at a fixed-point phase (power-of-two sizes)
+         * 
+         * Shifts and masks only: no wrap loops, no modulo and no float index.
+         * 
+         * @param phase Phase, 2^32 = one cycle (see PhaseAccumulator::tickFixed())
+         * @return Interpolated sample value (-1.0 to 1.0)
+         */
+        float lookupLinear(uint32_t phase) const noexcept {
+            static_assert(POWER_OF_TWO, "Fixed-point lookup needs a power-of-two table");
+            const Sample* taps = &storage_[GUARD_BEFORE + (phase >> FRAC_BITS)];
+            const float frac = static_cast<float>(phase & FRAC_MASK) * FRAC_SCALE;
+            
+            const auto s1 = static_cast<float>(taps[0]);
+            const auto s2 = static_cast<float>(taps[1]);
+            
+            return (s1 + frac * (s2 - s1)) * INV_SCALE;
+        }
+        
+        /**
+         * @brief Get the cubic-interpolated sample at a fixed-point phase (power-of-two sizes)
+         * @param phase Phase, 2^32 = one cycle (see PhaseAccumulator::tickFixed())
+         * @return Interpolated sample value (about -1.0 to 1.0; may overshoot slightly)
+         */
+        float lookupCubic(uint32_t phase) const noexcept {
+            static_assert(POWER_OF_TWO, "Fixed-point lookup needs a power-of-two table");
+            const float frac = static_cast<float>(phase & FRAC_MASK) * FRAC_SCALE;
+            return Detail::hermite(&storage_[GUARD_BEFORE + (phase >> FRAC_BITS) - 1], frac) * INV_SCALE;
+        }
+        
+        /**
+         * @brief Get table size
+         * @return Number of samples in the table (guards not included)
+         */
+        constexpr size_t size() const noexcept { return SIZE; }
+        
+        /**
+         * @brief Direct access to the samples
+         * 
+         * Points at sample 0 of SIZE; the guard samples can be read at
+         * [-GUARD_BEFORE] and [SIZE] to [SIZE + GUARD_AFTER - 1].
+         * 
+         * @return Pointer to the first sample of the cycle
+         */
+        constexpr const Sample* data() const noexcept {
+            return storage_.data() + GUARD_BEFORE;
+        }
+    };
+    
+    /**
+     * @brief Wavetable that stores one symmetric part of the cycle
+     * 
+     * Same interface as the flat Wavetable, for power-of-two sizes. The
+     * fixed-point lookups fold the phase with a few integer operations
+     * and no branches: the phase's top bit is the sign of the second
+     * half, XORed into the result's sign bit, and for QUARTER_WAVE bit
+     * 30 reflects the position within the quarter. The stored part has
+     * guard samples built from the symmetry, so interpolation taps never
+     * cross a fold.
+     * 
+     * @tparam SIZE Number of samples in the full cycle
+     * @tparam Base Format of the stored samples
+     * @tparam SYMMETRY Symmetry of the wave
+     */
+    template<size_t SIZE, typename Base, WaveSymmetry SYMMETRY>
+    class Wavetable<SIZE, SymmetricStorage<Base, SYMMETRY>> {
+    public:
+        using StorageType = SymmetricStorage<Base, SYMMETRY>;
+        using Sample = typename Base::Sample;
+        using SampleArray = std::array<Sample, SIZE>;
+        
+        static constexpr bool POWER_OF_TWO = SIZE >= 2 && (SIZE & (SIZE - 1)) == 0;
+        static_assert(POWER_OF_TWO && SIZE >= 8, "Symmetric tables need a power-of-two size of at least 8");
+        
+        static constexpr bool QUARTER = SYMMETRY == WaveSymmetry::QUARTER_WAVE;
+        static constexpr size_t PART = QUARTER ? SIZE / 4 : SIZE / 2;  ///< Samples per folded part
+        static constexpr size_t STORED = QUARTER ? PART + 1 : PART;     ///< Samples kept (quarter includes its peak)
+        static constexpr size_t GUARD_BEFORE = 1;
+        static constexpr size_t GUARD_AFTER = 2;
+        
+    private:
+        std::array<Sample, GUARD_BEFORE + STORED + GUARD_AFTER> storage_;
+        
+        static constexpr uint32_t indexBits() {
+            uint32_t bits = 0;
+            while ((static_cast<size_t>(1) << bits) < SIZE) {
+                ++bits;
+            }
+            return bits;
+        }
+        static constexpr uint32_t INDEX_BITS = indexBits();
+        static constexpr uint32_t FRAC_BITS = 32 - INDEX_BITS;
+        static constexpr uint32_t FRAC_MASK = 0xFFFFFFFFu >> INDEX_BITS;
+        static constexpr float FRAC_SCALE = 1.0f / static_cast<float>(1ull << FRAC_BITS);
+        static constexpr float PHASE_SCALE = static_cast<float>(1ull << FRAC_BITS);
+        static constexpr float INV_SCALE = 1.0f / Base::SCALE;
+        
+        static constexpr Sample negate(Sample value) {
+            return static_cast<Sample>(-value);
+        }
+        
+        /**
+         * @brief Phase folded onto the stored part (2^32 / SIZE per stored sample)
+         */
+        static uint32_t fold(uint32_t phase) noexcept {
+            if constexpr (QUARTER) {
+                // Odd quarters run backwards: 2^30 - position, from the peak down
+                const uint32_t mirror = 0u - ((phase >> 30) & 1u);
+                return ((phase & 0x3FFFFFFFu) ^ mirror) + (mirror & 0x40000001u);
+            } else {
+                return phase & (0xFFFFFFFFu >> 1);
+            }
+        }
+        
+        /**
+         * @brief Negate a value in the second half of the cycle
+         */
+        static float applySign(float value, uint32_t phase) noexcept {
+            uint32_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            bits ^= phase & 0x80000000u;
+            std::memcpy(&value, &bits, sizeof(bits));
+            return value;
+        }
+        
+        /**
+         * @brief Fractional index to phase (index wrapped first)
+         */
+        static uint32_t toPhase(float index) noexcept {
+            const float phase = Detail::wrapTableIndex<SIZE>(index) * PHASE_SCALE;
+            return static_cast<uint32_t>(std::min(phase, 4294967040.0f));
+        }
+        
+    public:
+        /**
+         * @brief Construct from one full cycle (only the stored part is kept)
+         * @param samples Pre-computed sample array (one cycle, no guards)
+         */
+        constexpr Wavetable(const SampleArray& samples) : storage_{} {
+            for (size_t i = 0; i < STORED; ++i) {
+                storage_[GUARD_BEFORE + i] = samples[i];
+            }
+            if constexpr (QUARTER) {
+                // Odd around 0, even around the peak
+                storage_[0] = negate(samples[1]);
+                storage_[GUARD_BEFORE + STORED] = samples[PART - 1];
+                storage_[GUARD_BEFORE + STORED + 1] = samples[PART - 2];
+            } else {
+                storage_[0] = negate(samples[PART - 1]);
+                storage_[GUARD_BEFORE + STORED] = negate(samples[0]);
+                storage_[GUARD_BEFORE + STORED + 1] = negate(samples[1]);
+            }
+        }
+        
+        /**
+         * @brief Get sample at exact index (no interpolation)
+         * @param index Sample index (will be wrapped)
+         * @return Stored sample value (Base::SCALE = 1.0)
+         */
+        constexpr Sample getSample(size_t index) const noexcept {
+            index %= SIZE;
+            size_t offset = index % PART;
+            if (QUARTER && (index / PART) % 2 != 0) {
+                offset = PART - offset;
+            }
+            const Sample value = storage_[GUARD_BEFORE + offset];
+            return index >= SIZE / 2 ? negate(value) : value;
+        }
+        
+        /**
+         * @brief Get interpolated sample at fractional index
+         * @param index Fractional sample index
+         * @return Interpolated sample value (-1.0 to 1.0)
+         */
+        float getInterpolated(float index) const noexcept {
+            return lookupLinear(toPhase(index));
+        }
+        
+        /**
+         * @brief Get cubic-interpolated sample at fractional index
+         * @param index Fractional sample index
+         * @return Interpolated sample value (about -1.0 to 1.0; may overshoot slightly)
+         */
+        float getCubic(float index) const noexcept {
+            return lookupCubic(toPhase(index));
+        }
+        
+        /**
+         * @brief Get the sample a fixed-point phase falls on
+         * @param phase Phase, 2^32 = one cycle
+         * @return Sample value (-1.0 to 1.0)
+         */
+        float lookupNearest(uint32_t phase) const noexcept {
+            uint32_t folded = fold(phase);
+            if constexpr (QUARTER) {
+                // Round up in the backwards quarters to truncate like the flat table
+                folded += (0u - ((phase >> 30) & 1u)) & FRAC_MASK;
+            }
+            const float value = static_cast<float>(storage_[GUARD_BEFORE + (folded >> FRAC_BITS)]);
+            return applySign(value * INV_SCALE, phase);
+        }
+        
+        /**
+         * @brief Get the interpolated sample at a fixed-point phase
+         * @param phase Phase, 2^32 = one cycle
+         * @return Interpolated sample value (-1.0 to 1.0)
+         */
+        float lookupLinear(uint32_t phase) const noexcept {
+            const uint32_t folded = fold(phase);
+            const Sample* taps = &storage_[GUARD_BEFORE + (folded >> FRAC_BITS)];
+            const float frac = static_cast<float>(folded & FRAC_MASK) * FRAC_SCALE;
             
-            const auto s1 = static_cast<float>(samples_[i1]);
-            const auto s2 = static_cast<float>(samples_[i2]);
+            const auto s1 = static_cast<float>(taps[0]);
+            const auto s2 = static_cast<float>(taps[1]);
             
-            return (s1 + frac * (s2 - s1)) / SAMPLE_SCALE;
+            return applySign((s1 + frac * (s2 - s1)) * INV_SCALE, phase);
+        }
+        
+        /**
+         * @brief Get the cubic-interpolated sample at a fixed-point phase
+         * @param phase Phase, 2^32 = one cycle
+         * @return Interpolated sample value (about -1.0 to 1.0; may overshoot slightly)
+         */
+        float lookupCubic(uint32_t phase) const noexcept {
+            const uint32_t folded = fold(phase);
+            const float frac = static_cast<float>(folded & FRAC_MASK) * FRAC_SCALE;
+            const float value = Detail::hermite(&storage_[GUARD_BEFORE + (folded >> FRAC_BITS) - 1], frac);
+            return applySign(value * INV_SCALE, phase);
         }
         
         /**
          * @brief Get table size
-         * @return Number of samples in the table
+         * @return Number of samples in the full cycle
          */
         constexpr size_t size() const noexcept { return SIZE; }
         
         /**
-         * @brief Direct access to sample array
-         * @return Reference to internal sample array
+         * @brief Direct access to the stored part
+         * 
+         * Points at sample 0; STORED samples follow, with guard samples
+         * at [-GUARD_BEFORE] and [STORED] to [STORED + GUARD_AFTER - 1].
+         * 
+         * @return Pointer to the first stored sample
          */
-        constexpr const SampleArray& data() const noexcept { return samples_; }
+        constexpr const Sample* data() const noexcept {
+            return storage_.data() + GUARD_BEFORE;
+        }
     };
     
     /**
      * @brief Generate wavetable from formula function
      * @tparam SIZE Number of samples to generate
+     * @tparam Storage Sample storage policy
      * @param generator Function that takes sample index and returns float value (-1.0 to 1.0)
      * @return Generated wavetable
      */
-    template<size_t SIZE>
+    template<size_t SIZE, typename Storage = Q15Storage>
     constexpr auto generateWavetable(std::function<float(size_t)> generator) {
-        typename Wavetable<SIZE>::SampleArray samples{};
+        typename Wavetable<SIZE, Storage>::SampleArray samples{};
         
         for (size_t i = 0; i < SIZE; ++i) {
-            const float value = std::clamp(generator(i), -1.0f, 1.0f);
-            samples[i] = static_cast<WavetableSample>(value * SAMPLE_SCALE);
+            samples[i] = Storage::encode(generator(i));
         }
         
-        return Wavetable<SIZE>(samples);
+        return Wavetable<SIZE, Storage>(samples);
     }
     
     /**
      * @brief Generate wavetable from lambda (compile-time friendly)
      * @tparam SIZE Number of samples to generate
+     * @tparam Storage Sample storage policy
      * @tparam Generator Lambda or function object type
      * @param generator Callable that takes sample index and returns float value
      * @return Generated wavetable
      */
-    template<size_t SIZE, typename Generator>
+    template<size_t SIZE, typename Storage = Q15Storage, typename Generator>
     constexpr auto makeWavetable(Generator generator) {
-        typename Wavetable<SIZE>::SampleArray samples{};
+        typename Wavetable<SIZE, Storage>::SampleArray samples{};
         
         for (size_t i = 0; i < SIZE; ++i) {
-            const float value = std::clamp(generator(i), -1.0f, 1.0f);
-            samples[i] = static_cast<WavetableSample>(value * SAMPLE_SCALE);
+            samples[i] = Storage::encode(generator(i));
         }
         
-        return Wavetable<SIZE>(samples);
+        return Wavetable<SIZE, Storage>(samples);
     }
     
     /**
      * @brief Generate wavetable from sample array
      * @tparam SIZE Number of samples
+     * @tparam Storage Sample storage policy
      * @param samples Array of float samples (-1.0 to 1.0)
      * @return Generated wavetable
      */
-    template<size_t SIZE>
+    template<size_t SIZE, typename Storage = Q15Storage>
     constexpr auto makeWavetable(const std::array<float, SIZE>& samples) {
-        typename Wavetable<SIZE>::SampleArray int_samples{};
+        typename Wavetable<SIZE, Storage>::SampleArray stored{};
+        
+        for (size_t i = 0; i < SIZE; ++i) {
+            stored[i] = Storage::encode(samples[i]);
+        }
+        
+        return Wavetable<SIZE, Storage>(stored);
+    }
+    
+    /**
+     * @brief Re-store a wavetable in another format
+     * 
+     * For example a float copy of a hot Q15 table, or an 8-bit copy of a
+     * large bank: convertWavetable<FloatStorage>(Wavetables::Basic::SINE).
+     * 
+     * @tparam To Storage policy of the copy
+     * @param table Source wavetable
+     * @return Converted wavetable
+     */
+    template<typename To, size_t SIZE, typename From>
+    constexpr auto convertWavetable(const Wavetable<SIZE, From>& table) {
+        typename Wavetable<SIZE, To>::SampleArray stored{};
+        
+        for (size_t i = 0; i < SIZE; ++i) {
+            stored[i] = To::encode(static_cast<float>(table.getSample(i)) / From::SCALE);
+        }
+        
+        return Wavetable<SIZE, To>(stored);
+    }
+    
+    /**
+     * @brief Mip level and crossfade chosen for a phase increment
+     */
+    struct MipSelection {
+        uint8_t level = 0;      ///< Richest level that cannot alias
+        float blend = 0.0f;     ///< Amount of the next (duller) level, 0.0 to 1.0
+    };
+    
+    /**
+     * @brief Band-limited wavetable with one level per octave
+     * 
+     * Level 0 holds SIZE / 8 harmonics and every level after it half as
+     * many, down to a single sine, all at the same table size (8 or more
+     * samples per cycle of the highest harmonic keeps interpolation
+     * images low). Level k stays below Nyquist up to a phase increment of
+     * 2^k / (2 * MAX_HARMONICS) cycles per sample, so the oscillator picks
+     * levels from its increment alone, whatever the sample rate.
+     * 
+     * @tparam SIZE Samples per level (power of two, at least 8)
+     * @tparam Storage Sample storage policy of the levels
+     */
+    template<size_t SIZE, typename Storage = Q15Storage>
+    class MipmapWavetable {
+    public:
+        static_assert(Wavetable<SIZE>::POWER_OF_TWO && SIZE >= 8,
+                      "Mipmapped tables need a power-of-two size of at least 8");
+        
+        static constexpr size_t MAX_HARMONICS = SIZE / 8;   ///< Harmonics in level 0
+        
+    private:
+        static constexpr size_t levelCount() {
+            size_t levels = 1;
+            while ((MAX_HARMONICS >> levels) > 0) {
+                ++levels;
+            }
+            return levels;
+        }
+        
+        // Largest fixed-point increment (2^32 = one cycle) level 0 plays alias-free
+        static constexpr uint64_t LEVEL0_LIMIT = (1ull << 31) / MAX_HARMONICS;
+        
+    public:
+        static constexpr size_t LEVELS = levelCount();      ///< MAX_HARMONICS down to 1
+        using Level = Wavetable<SIZE, Storage>;
+        using LevelArray = std::array<Level, LEVELS>;
+        
+        /**
+         * @brief Number of harmonics in a level
+         * @param level Level index (0 = richest)
+         */
+        static constexpr size_t harmonics(size_t level) noexcept {
+            return level < LEVELS ? MAX_HARMONICS >> level : 1;
+        }
+        
+        /**
+         * @brief Choose the levels to play at a phase increment
+         * 
+         * Picks the richest level whose top harmonic stays below Nyquist
+         * and fades linearly into the next level across its octave, so
+         * the mix reaches that level exactly where the first one would
+         * start to alias. Negative increments count by their magnitude.
+         * 
+         * @param increment Phase increment, 2^32 = one cycle per sample
+         * @return Level and crossfade amount
+         */
+        static MipSelection select(uint32_t increment) noexcept {
+            const uint32_t speed = increment > 0x80000000u ? 0u - increment : increment;
+            
+            uint64_t limit = LEVEL0_LIMIT;
+            size_t level = 0;
+            while (level + 1 < LEVELS && speed > limit) {
+                limit <<= 1;
+                ++level;
+            }
+            
+            MipSelection selection;
+            selection.level = static_cast<uint8_t>(level);
+            if (level + 1 < LEVELS) {
+                const float position = static_cast<float>(speed) / (static_cast<float>(limit) * 0.5f);
+                selection.blend = std::clamp(position - 1.0f, 0.0f, 1.0f);
+            }
+            return selection;
+        }
+        
+    private:
+        LevelArray levels_;
+        
+    public:
+        constexpr MipmapWavetable(const LevelArray& levels) : levels_(levels) {}
+        
+        /**
+         * @brief Get one level
+         * @param level Level index (clamped to the last level)
+         * @return Wavetable holding harmonics(level) harmonics
+         */
+        constexpr const Level& getLevel(size_t level) const noexcept {
+            return levels_[level < LEVELS ? level : LEVELS - 1];
+        }
         
+        constexpr size_t numLevels() const noexcept { return LEVELS; }
+        constexpr size_t size() const noexcept { return SIZE; }
+    };
+    
+    /**
+     * @brief Fourier coefficients of one harmonic
+     */
+    struct Harmonic {
+        double sine = 0.0;      ///< Amplitude of sin(h * x)
+        double cosine = 0.0;    ///< Amplitude of cos(h * x)
+    };
+    
+    namespace Detail {
+        template<typename Table, size_t LEVELS, size_t... K>
+        constexpr std::array<Table, LEVELS> toWavetables(
+                const std::array<typename Table::SampleArray, LEVELS>& levels,
+                std::index_sequence<K...>) {
+            return {{ Table(levels[K])... }};
+        }
+    }
+    
+    /**
+     * @brief Generate a mipmapped wavetable by additive synthesis
+     * 
+     * Sums the harmonic series once per sample, storing the partial sum
+     * at each level's harmonic count, then scales every level by the same
+     * factor so the loudest one (usually level 0, with its Gibbs
+     * overshoot) just fits. Levels therefore keep their relative
+     * loudness and crossfade without a level jump. The DC term is left
+     * out.
+     * 
+     * @tparam SIZE Samples per level
+     * @tparam Storage Sample storage policy
+     * @tparam Spectrum Callable taking a harmonic number (1 and up) and returning a Harmonic
+     * @param spectrum Fourier series of the waveform
+     * @return Generated mipmapped wavetable
+     */
+    template<size_t SIZE, typename Storage = Q15Storage, typename Spectrum>
+    constexpr auto makeMipmapWavetable(Spectrum spectrum) {
+        using Mipmap = MipmapWavetable<SIZE, Storage>;
+        constexpr size_t LEVELS = Mipmap::LEVELS;
+        constexpr size_t MAX_HARMONICS = Mipmap::MAX_HARMONICS;
+        
+        // Plain arrays: std::array's operator[] is a call per access in
+        // the constant evaluator and multiplies the compile time
+        double sines[MAX_HARMONICS + 1] = {};
+        double cosines[MAX_HARMONICS + 1] = {};
+        for (size_t h = 1; h <= MAX_HARMONICS; ++h) {
+            const Harmonic harmonic = spectrum(h);
+            sines[h] = harmonic.sine;
+            cosines[h] = harmonic.cosine;
+        }
+        
+        double sums[LEVELS][SIZE] = {};
+        double peak = 0.0;
         for (size_t i = 0; i < SIZE; ++i) {
-            const float value = std::clamp(samples[i], -1.0f, 1.0f);
-            int_samples[i] = static_cast<WavetableSample>(value * SAMPLE_SCALE);
+            // sin(h x) and cos(h x) by rotation: one sin/cos per sample
+            const double x = 2.0 * M_PI * static_cast<double>(i) / SIZE;
+            const double c1 = std::cos(x);
+            const double s1 = std::sin(x);
+            double c = 1.0;
+            double s = 0.0;
+            double sum = 0.0;
+            
+            // Levels are prefixes of the series: fill from the dullest up
+            size_t level = LEVELS - 1;
+            size_t level_end = 1;
+            for (size_t h = 1; h <= MAX_HARMONICS; ++h) {
+                const double next_c = c * c1 - s * s1;
+                s = s * c1 + c * s1;
+                c = next_c;
+                sum += sines[h] * s + cosines[h] * c;
+                
+                if (h == level_end) {
+                    sums[level][i] = sum;
+                    peak = std::max(peak, sum < 0.0 ? -sum : sum);
+                    --level;
+                    level_end <<= 1;
+                }
+            }
+        }
+        
+        const double scale = peak > 0.0 ? 1.0 / peak : 0.0;
+        std::array<typename Mipmap::Level::SampleArray, LEVELS> samples{};
+        for (size_t k = 0; k < LEVELS; ++k) {
+            typename Mipmap::Level::Sample* row = samples[k].data();
+            for (size_t i = 0; i < SIZE; ++i) {
+                row[i] = Storage::encode(static_cast<float>(sums[k][i] * scale));
+            }
         }
         
-        return Wavetable<SIZE>(int_samples);
+        return Mipmap(Detail::toWavetables<typename Mipmap::Level, LEVELS>(
+            samples, std::make_index_sequence<LEVELS>{}));
     }
     
     /**
      * @brief Collection of multiple wavetables
      * @tparam NumWaves Number of wavetables
      * @tparam WaveSize Samples per wavetable
+     * @tparam Storage Sample storage policy of the wavetables
      */
-    template<size_t NumWaves, size_t WaveSize>
+    template<size_t NumWaves, size_t WaveSize, typename Storage = Q15Storage>
     class WavetableBank {
     public:
-        using WaveArray = std::array<Wavetable<WaveSize>, NumWaves>;
+        using Wave = Wavetable<WaveSize, Storage>;
+        using WaveArray = std::array<Wave, NumWaves>;
         
     private:
         WaveArray waves_;
@@ -157,7 +802,7 @@ namespace KoeKit {
     public:
         constexpr WavetableBank(const WaveArray& waves) : waves_(waves) {}
         
-        constexpr const Wavetable<WaveSize>& getWave(size_t index) const noexcept {
+        constexpr const Wave& getWave(size_t index) const noexcept {
             return waves_[index % NumWaves];
         }
         
@@ -0,0 +1,75 @@
+#pragma once
+
+/**
+ * @file bandlimited.h
+ * @brief Band-limited, per-octave mipmapped waveforms
+ *
+ * Not included by KoeKit.h: generating the four mipmaps adds a few
+ * seconds to the compile of every file that includes this header, so
+ * only sketches that play them should:
+ *
+ *   #include <KoeKit.h>
+ *   #include <wavetables/bandlimited.h>
+ *
+ *   KoeKit::BandLimitedOscillator saw(KoeKit::Wavetables::BandLimited::SAW);
+ *
+ * Each mipmap is 8 levels of KOEKIT_WAVETABLE_SIZE samples (16 KB of
+ * flash at the default size); only the ones a sketch uses are linked.
+ */
+
+#ifndef KOEKIT_WAVETABLES_BANDLIMITED_H
+#define KOEKIT_WAVETABLES_BANDLIMITED_H
+
+#include "../core/wavetable_generator.h"
+#include <cmath>
+
+namespace KoeKit {
+namespace Wavetables {
+namespace BandLimited {
+    
+    constexpr size_t BANDLIMITED_TABLE_SIZE = KOEKIT_WAVETABLE_SIZE;
+    
+    /**
+     * @brief Sawtooth rising from -1 to 1 over the cycle (as Basic::SAW)
+     */
+    constexpr Harmonic sawHarmonic(size_t h) {
+        return Harmonic{-2.0 / (M_PI * static_cast<double>(h)), 0.0};
+    }
+    
+    /**
+     * @brief Square, high for the first half of the cycle (as Basic::SQUARE)
+     */
+    constexpr Harmonic squareHarmonic(size_t h) {
+        return Harmonic{(h % 2 != 0) ? 4.0 / (M_PI * static_cast<double>(h)) : 0.0, 0.0};
+    }
+    
+    /**
+     * @brief Triangle, lowest at the start of the cycle (as Basic::TRIANGLE)
+     */
+    constexpr Harmonic triangleHarmonic(size_t h) {
+        const auto n = static_cast<double>(h);
+        return Harmonic{0.0, (h % 2 != 0) ? -8.0 / (M_PI * M_PI * n * n) : 0.0};
+    }
+    
+    /**
+     * @brief 25% pulse, high for the first quarter of the cycle (as Basic::PULSE, without its DC)
+     */
+    constexpr Harmonic pulseHarmonic(size_t h) {
+        // sin and cos of h * pi / 2 cycle through four values
+        constexpr double SIN_QUARTER[4] = {0.0, 1.0, 0.0, -1.0};
+        constexpr double COS_QUARTER[4] = {1.0, 0.0, -1.0, 0.0};
+        const double a = 2.0 / (M_PI * static_cast<double>(h));
+        return Harmonic{a * (1.0 - COS_QUARTER[h % 4]), a * SIN_QUARTER[h % 4]};
+    }
+    
+    // Pre-computed mipmaps (available at compile time)
+    inline constexpr auto SAW = makeMipmapWavetable<BANDLIMITED_TABLE_SIZE>(sawHarmonic);
+    inline constexpr auto SQUARE = makeMipmapWavetable<BANDLIMITED_TABLE_SIZE>(squareHarmonic);
+    inline constexpr auto TRIANGLE = makeMipmapWavetable<BANDLIMITED_TABLE_SIZE>(triangleHarmonic);
+    inline constexpr auto PULSE = makeMipmapWavetable<BANDLIMITED_TABLE_SIZE>(pulseHarmonic);
+
+} // namespace BandLimited
+} // namespace Wavetables
+} // namespace KoeKit
+
+#endif // KOEKIT_WAVETABLES_BANDLIMITED_H
@@ -20,8 +20,9 @@ namespace Basic {
     /**
      * @brief Generate sine wave table
      */
+    template<typename Storage = Q15Storage>
     constexpr auto makeSineTable() {
-        return makeWavetable<BASIC_TABLE_SIZE>([](size_t i) -> float {
+        return makeWavetable<BASIC_TABLE_SIZE, Storage>([](size_t i) -> float {
             const float phase = 2.0f * M_PI * static_cast<float>(i) / BASIC_TABLE_SIZE;
             return std::sin(phase);
         });
@@ -30,8 +31,9 @@ namespace Basic {
     /**
      * @brief Generate sawtooth wave table
      */
+    template<typename Storage = Q15Storage>
     constexpr auto makeSawTable() {
-        return makeWavetable<BASIC_TABLE_SIZE>([](size_t i) -> float {
+        return makeWavetable<BASIC_TABLE_SIZE, Storage>([](size_t i) -> float {
             return 2.0f * static_cast<float>(i) / (BASIC_TABLE_SIZE - 1) - 1.0f;
         });
     }
@@ -39,8 +41,9 @@ namespace Basic {
     /**
      * @brief Generate square wave table
      */
+    template<typename Storage = Q15Storage>
     constexpr auto makeSquareTable() {
-        return makeWavetable<BASIC_TABLE_SIZE>([](size_t i) -> float {
+        return makeWavetable<BASIC_TABLE_SIZE, Storage>([](size_t i) -> float {
             return (i < BASIC_TABLE_SIZE / 2) ? 1.0f : -1.0f;
         });
     }
@@ -48,8 +51,9 @@ namespace Basic {
     /**
      * @brief Generate triangle wave table
      */
+    template<typename Storage = Q15Storage>
     constexpr auto makeTriangleTable() {
-        return makeWavetable<BASIC_TABLE_SIZE>([](size_t i) -> float {
+        return makeWavetable<BASIC_TABLE_SIZE, Storage>([](size_t i) -> float {
             if (i < BASIC_TABLE_SIZE / 2) {
                 return 4.0f * static_cast<float>(i) / BASIC_TABLE_SIZE - 1.0f;
             } else {
@@ -61,8 +65,9 @@ namespace Basic {
     /**
      * @brief Generate soft sawtooth with reduced harmonics
      */
+    template<typename Storage = Q15Storage>
     constexpr auto makeSoftSawTable() {
-        return makeWavetable<BASIC_TABLE_SIZE>([](size_t i) -> float {
+        return makeWavetable<BASIC_TABLE_SIZE, Storage>([](size_t i) -> float {
             const float phase = 2.0f * M_PI * static_cast<float>(i) / BASIC_TABLE_SIZE;
             float result = 0.0f;
             
@@ -78,8 +83,9 @@ namespace Basic {
     /**
      * @brief Generate pulse wave with 25% duty cycle
      */
+    template<typename Storage = Q15Storage>
     constexpr auto makePulseTable() {
-        return makeWavetable<BASIC_TABLE_SIZE>([](size_t i) -> float {
+        return makeWavetable<BASIC_TABLE_SIZE, Storage>([](size_t i) -> float {
             return (i < BASIC_TABLE_SIZE / 4) ? 1.0f : -1.0f;
         });
     }
@@ -92,6 +98,12 @@ namespace Basic {
     inline constexpr auto SOFT_SAW = makeSoftSawTable();
     inline constexpr auto PULSE = makePulseTable();
     
+    // Symmetry-compressed copies in a quarter (sine) or half the flash;
+    // play them with QuarterWaveOscillator and HalfWaveOscillator
+    inline constexpr auto SINE_COMPACT = makeSineTable<QuarterWaveStorage<>>();
+    inline constexpr auto SQUARE_COMPACT = makeSquareTable<HalfWaveStorage<>>();
+    inline constexpr auto TRIANGLE_COMPACT = makeTriangleTable<HalfWaveStorage<>>();
+    
     /**
      * @brief Basic waveform bank containing all basic waves
      */
@@ -124,7 +136,7 @@ namespace Basic {
     constexpr const auto& getWavetable(Waveform waveform) {
         return BASIC_BANK.getWave(static_cast<size_t>(waveform));
     }
-    
+
 } // namespace Basic
 } // namespace Wavetables
 } // namespace KoeKit